@@ -786,3 +786,160 @@ qreal OpenGlDrawing::drawText(QPainter *painter, const QColor &color, const Open
         return height;
     }
 }
+
+
+
+OpenGlTextAtlas::OpenGlTextAtlas() {
+    texture    = 0;
+    dirty      = false;
+    fontHeight = 0;
+    dpi        = 0;
+    packX = packY = packRowHeight = 0;
+}
+void OpenGlTextAtlas::setFont(const OpenGlFont &_font) {
+    font = _font;
+    image = QImage();
+}
+void OpenGlTextAtlas::clear() {
+    //Glyphs are rasterized at screen resolution, quads stay in font pixels
+    dpi = OpenGlDrawing::dpi;
+    if(image.isNull())
+        image = QImage(QSize(OPENGL_TEXTATLAS_SIZE, OPENGL_TEXTATLAS_SIZE) * dpi, QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+    glyphs.clear();
+    fontHeight = QFontMetricsF(font).height();
+    packX = packY = packRowHeight = 0;
+    dirty = true;
+}
+const OpenGlGlyph & OpenGlTextAtlas::getGlyph(const QChar &character) {
+    if((image.isNull()) || (dpi != OpenGlDrawing::dpi))
+        clear();
+    QHash<ushort, OpenGlGlyph>::const_iterator glyphIterator = glyphs.constFind(character.unicode());
+    if(glyphIterator != glyphs.constEnd())
+        return glyphIterator.value();
+
+    //Shelf packing of a new glyph
+    QFontMetricsF fontMetrics(font);
+    QRectF bounds = fontMetrics.boundingRect(character);
+    quint16 width  = qCeil((qMax(bounds.right(), fontMetrics.width(character)) - qMin((qreal)0, bounds.left()) + 2*OPENGL_TEXTATLAS_PADDING) * dpi);
+    quint16 height = qCeil((fontHeight + 2*OPENGL_TEXTATLAS_PADDING) * dpi);
+    if(packX + width > image.width()) {
+        packX  = 0;
+        packY += packRowHeight;
+        packRowHeight = 0;
+    }
+    if(packY + height > image.height()) {
+        //Atlas full: draw what uses it, then start again
+        draw();
+        clear();
+    }
+
+    QPainter painter(&image);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+    painter.setPen(Qt::white);
+    painter.setFont(font);
+    painter.translate(packX, packY);
+    painter.scale(dpi, dpi);
+    painter.drawText(QPointF(OPENGL_TEXTATLAS_PADDING - qMin((qreal)0, bounds.left()), OPENGL_TEXTATLAS_PADDING + fontMetrics.ascent()), QString(character));
+    painter.end();
+
+    OpenGlGlyph glyph;
+    glyph.advance = fontMetrics.width(character);
+    glyph.quad    = QRectF(qMin((qreal)0, bounds.left()) - OPENGL_TEXTATLAS_PADDING, -OPENGL_TEXTATLAS_PADDING, width / dpi, height / dpi);
+    //Atlas is uploaded bottom-up, as every other texture
+    glyph.texture = QRectF((qreal)packX / image.width(), 1 - (qreal)packY / image.height(), (qreal)width / image.width(), -(qreal)height / image.height());
+    packX += width;
+    packRowHeight = qMax(packRowHeight, height);
+    dirty = true;
+    return glyphs.insert(character.unicode(), glyph).value();
+}
+void OpenGlTextAtlas::addText(qreal x, qreal y, qreal z, const QString &text, qreal textScale, bool billboarded) {
+    //Quads are stored in eye space so that every label of the frame is drawn at once
+    GLfloat modelview[16], color[4];
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+    glGetFloatv(GL_CURRENT_COLOR, color);
+    GLfloat anchor[3];
+    for(quint8 i = 0 ; i < 3 ; i++)
+        anchor[i] = modelview[i] * x + modelview[4+i] * y + modelview[8+i] * z + modelview[12+i];
+    qreal anchorScale = qSqrt(modelview[0]*modelview[0] + modelview[1]*modelview[1] + modelview[2]*modelview[2]) * textScale;
+
+    qreal penX = 0, penY = 0;
+    foreach(const QChar &character, text) {
+        if(character == '\n') {
+            penX  = 0;
+            penY += fontHeight;
+            continue;
+        }
+        const OpenGlGlyph &glyph = getGlyph(character);
+        if(!character.isSpace()) {
+            qreal corners[4][2] = {
+                {penX + glyph.quad.left(),  penY + glyph.quad.top()},
+                {penX + glyph.quad.right(), penY + glyph.quad.top()},
+                {penX + glyph.quad.right(), penY + glyph.quad.bottom()},
+                {penX + glyph.quad.left(),  penY + glyph.quad.bottom()}
+            };
+            qreal uvs[4][2] = {
+                {glyph.texture.left(),  glyph.texture.top()},
+                {glyph.texture.right(), glyph.texture.top()},
+                {glyph.texture.right(), glyph.texture.bottom()},
+                {glyph.texture.left(),  glyph.texture.bottom()}
+            };
+            for(quint8 corner = 0 ; corner < 4 ; corner++) {
+                //Text runs to the right and downwards from the anchor
+                if(billboarded) {
+                    vertices << anchor[0] + corners[corner][0] * anchorScale << anchor[1] - corners[corner][1] * anchorScale << anchor[2];
+                }
+                else {
+                    qreal lx = x + corners[corner][0] * textScale, ly = y - corners[corner][1] * textScale;
+                    for(quint8 i = 0 ; i < 3 ; i++)
+                        vertices << modelview[i] * lx + modelview[4+i] * ly + modelview[8+i] * z + modelview[12+i];
+                }
+                texCoords << uvs[corner][0] << uvs[corner][1];
+                colors << color[0] << color[1] << color[2] << color[3];
+            }
+        }
+        penX += glyph.advance;
+    }
+}
+void OpenGlTextAtlas::draw() {
+    if(vertices.isEmpty())
+        return;
+
+    //Upload the atlas after new glyphs
+    glEnable(GL_TEXTURE_2D);
+    if(!texture) {
+        glGenTextures(1, &texture);
+        dirty = true;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if(dirty) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width(), image.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, QGLWidget::convertToGLFormat(image).bits());
+        dirty = false;
+    }
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+    //Single batched draw
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer  (3, GL_FLOAT, 0, vertices.constData());
+    glTexCoordPointer(2, GL_FLOAT, 0, texCoords.constData());
+    glColorPointer   (4, GL_FLOAT, 0, colors.constData());
+    glDrawArrays(GL_QUADS, 0, vertices.count() / 3);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPopMatrix();
+    glDisable(GL_TEXTURE_2D);
+
+    vertices.resize(0);
+    texCoords.resize(0);
+    colors.resize(0);
+}
@@ -397,6 +397,40 @@ public:
     static qreal drawText(QPainter *painter, const QColor &color, const OpenGlFont &font, const QRectF &rect, const QString &text);
 };
 
+#define OPENGL_TEXTATLAS_SIZE    1024
+#define OPENGL_TEXTATLAS_PADDING 2
+
+class OpenGlGlyph {
+public:
+    QRectF quad, texture;
+    qreal  advance;
+};
+
+class OpenGlTextAtlas {
+public:
+    explicit OpenGlTextAtlas();
+
+public:
+    void setFont(const OpenGlFont &_font);
+    void resetTexture() { texture = 0; dirty = true; }
+    void addText(qreal x, qreal y, qreal z, const QString &text, qreal textScale, bool billboarded);
+    void draw();
+
+private:
+    const OpenGlGlyph & getGlyph(const QChar &character);
+    void clear();
+
+private:
+    OpenGlFont font;
+    qreal      fontHeight, dpi;
+    QImage     image;
+    GLuint     texture;
+    bool       dirty;
+    quint16    packX, packY, packRowHeight;
+    QHash<ushort, OpenGlGlyph> glyphs;
+    QVector<GLfloat> vertices, texCoords, colors;
+};
+
 
 
 #endif // ABSTRACTIONSGL_H
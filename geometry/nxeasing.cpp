@@ -23,6 +23,23 @@
 
 #include "nxeasing.h"
 
+QVector<qreal> NxEasing::tables[QEasingCurve::NCurveTypes];
+
+const qreal* NxEasing::getTable(quint16 type) {
+    //Linear and custom easings are evaluated directly
+    if((type == QEasingCurve::Linear) || (type >= QEasingCurve::Custom))
+        return 0;
+
+    //Sampled once, on first use of the type
+    if(tables[type].isEmpty()) {
+        QEasingCurve curve((QEasingCurve::Type)type);
+        tables[type].resize(NXEASING_TABLE_SIZE + 1);
+        for(quint16 index = 0 ; index <= NXEASING_TABLE_SIZE ; index++)
+            tables[type][index] = qBound(qreal(0.), curve.valueForProgress((qreal)index / (qreal)NXEASING_TABLE_SIZE), qreal(1.));
+    }
+    return tables[type].constData();
+}
+
 const QPixmap NxEasing::getPixmap() const {
     QPixmap pixmap(128, 128);
     pixmap.fill(Qt::transparent);
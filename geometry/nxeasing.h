@@ -25,20 +25,37 @@
 #define NXEASING_H
 
 #include <QEasingCurve>
+#include <QVector>
 #include <QPixmap>
 #include <QPainter>
 
+#define NXEASING_TABLE_SIZE 4096
+
 class NxEasing {
+public:
+    NxEasing() { table = 0; }
+
 private:
     QEasingCurve easing;
+    const qreal *table;
+    static QVector<qreal> tables[QEasingCurve::NCurveTypes];
+    static const qreal* getTable(quint16 type);
 
 public:
     const QPixmap getPixmap() const;
 
 public:
-    inline void setType(quint16 type)           { easing.setType((QEasingCurve::Type)type); }
+    inline void setType(quint16 type)           { easing.setType((QEasingCurve::Type)type); table = getTable(type); }
     inline quint16 getType() const              { return easing.type(); }
-    inline qreal getValue(qreal progress) const { return qBound(qreal(0.), easing.valueForProgress(progress), qreal(1.)); }
+    inline qreal getValue(qreal progress) const {
+        if(!table)
+            return qBound(qreal(0.), easing.valueForProgress(progress), qreal(1.));
+
+        //Linear interpolation in the table shared by all the easings of this type
+        qreal position = qBound(qreal(0.), progress, qreal(1.)) * NXEASING_TABLE_SIZE;
+        quint16 index  = qMin((quint16)position, (quint16)(NXEASING_TABLE_SIZE - 1));
+        return table[index] + (table[index+1] - table[index]) * (position - index);
+    }
 };
 
 #endif // NXEASING_H
@@ -333,6 +333,83 @@ namespace mu
     DefineInfixOprt(_T("+"), UnaryPlus);
   }
 
+  //---------------------------------------------------------------------------
+  /** \brief Derivatives of the default functions, used by EvalDerivative.
+      \param a_pFun The function callback
+      \param a_iArgc Number of arguments, negative for functions with a variable number of arguments
+      \param a_fArg The function arguments
+      \param a_fDiff The derivatives of the function arguments
+      \param [out] a_fResult The derivative of the function
+      \return false if the function is not one of the default functions
+  */
+  bool Parser::DiffFun(generic_fun_type a_pFun, int a_iArgc, const value_type *a_fArg, const value_type *a_fDiff, value_type &a_fResult) const
+  {
+    if (a_iArgc==1)
+    {
+      value_type v = a_fArg[0], dv = a_fDiff[0];
+      if      (a_pFun==(generic_fun_type)Sin)        a_fResult =  MathImpl<value_type>::Cos(v) * dv;
+      else if (a_pFun==(generic_fun_type)Cos)        a_fResult = -MathImpl<value_type>::Sin(v) * dv;
+      else if (a_pFun==(generic_fun_type)Tan)        a_fResult =  dv / (MathImpl<value_type>::Cos(v) * MathImpl<value_type>::Cos(v));
+      else if (a_pFun==(generic_fun_type)ASin)       a_fResult =  dv / MathImpl<value_type>::Sqrt(1 - v*v);
+      else if (a_pFun==(generic_fun_type)ACos)       a_fResult = -dv / MathImpl<value_type>::Sqrt(1 - v*v);
+      else if (a_pFun==(generic_fun_type)ATan)       a_fResult =  dv / (1 + v*v);
+      else if (a_pFun==(generic_fun_type)Sinh)       a_fResult =  MathImpl<value_type>::Cosh(v) * dv;
+      else if (a_pFun==(generic_fun_type)Cosh)       a_fResult =  MathImpl<value_type>::Sinh(v) * dv;
+      else if (a_pFun==(generic_fun_type)Tanh)       a_fResult =  dv * (1 - MathImpl<value_type>::Tanh(v) * MathImpl<value_type>::Tanh(v));
+      else if (a_pFun==(generic_fun_type)ASinh)      a_fResult =  dv / MathImpl<value_type>::Sqrt(v*v + 1);
+      else if (a_pFun==(generic_fun_type)ACosh)      a_fResult =  dv / MathImpl<value_type>::Sqrt(v*v - 1);
+      else if (a_pFun==(generic_fun_type)ATanh)      a_fResult =  dv / (1 - v*v);
+      else if (a_pFun==(generic_fun_type)Log2)       a_fResult =  dv / (v * MathImpl<value_type>::Log((value_type)2));
+      else if (a_pFun==(generic_fun_type)Log10)      a_fResult =  dv / (v * MathImpl<value_type>::Log((value_type)10));
+      else if (a_pFun==(generic_fun_type)Ln)         a_fResult =  dv / v;
+      else if (a_pFun==(generic_fun_type)Exp)        a_fResult =  MathImpl<value_type>::Exp(v) * dv;
+      else if (a_pFun==(generic_fun_type)Abs)        a_fResult =  MathImpl<value_type>::Sign(v) * dv;
+      else if (a_pFun==(generic_fun_type)Sqrt)       a_fResult =  dv / (2 * MathImpl<value_type>::Sqrt(v));
+      else if (a_pFun==(generic_fun_type)Rint)       a_fResult =  0;
+      else if (a_pFun==(generic_fun_type)Sign)       a_fResult =  0;
+      else if (a_pFun==(generic_fun_type)UnaryMinus) a_fResult = -dv;
+      else if (a_pFun==(generic_fun_type)UnaryPlus)  a_fResult =  dv;
+      else
+        return false;
+      return true;
+    }
+    else if (a_iArgc==2)
+    {
+      // atan2(y, x)
+      if (a_pFun==(generic_fun_type)ATan2)
+      {
+        value_type y = a_fArg[0], x = a_fArg[1];
+        a_fResult = (x * a_fDiff[0] - y * a_fDiff[1]) / (x*x + y*y);
+        return true;
+      }
+      return false;
+    }
+    else if (a_iArgc<0)
+    {
+      int iArgc = -a_iArgc;
+      if ((a_pFun==(generic_fun_type)Sum) || (a_pFun==(generic_fun_type)Avg))
+      {
+        a_fResult = 0;
+        for (int i=0; i<iArgc; ++i)
+          a_fResult += a_fDiff[i];
+        if (a_pFun==(generic_fun_type)Avg)
+          a_fResult /= iArgc;
+        return true;
+      }
+      else if ((a_pFun==(generic_fun_type)Min) || (a_pFun==(generic_fun_type)Max))
+      {
+        // derivative of the selected argument
+        int iSel = 0;
+        for (int i=1; i<iArgc; ++i)
+          if ((a_pFun==(generic_fun_type)Min) ? (a_fArg[i]<a_fArg[iSel]) : (a_fArg[i]>a_fArg[iSel]))
+            iSel = i;
+        a_fResult = a_fDiff[iSel];
+        return true;
+      }
+    }
+    return false;
+  }
+
   //---------------------------------------------------------------------------
   void Parser::OnDetectVar(string_type * /*pExpr*/, int & /*nStart*/, int & /*nEnd*/)
   {
@@ -66,6 +66,12 @@ namespace mu
 
   protected:
 
+    virtual bool DiffFun(generic_fun_type a_pFun,
+                         int a_iArgc,
+                         const value_type *a_fArg,
+                         const value_type *a_fDiff,
+                         value_type &a_fResult) const;
+
     // Trigonometric functions
     static value_type  Sin(value_type);
     static value_type  Cos(value_type);
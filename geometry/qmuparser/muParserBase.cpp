@@ -1677,6 +1677,180 @@ namespace mu
     return &m_vStackBuffer[1];
   }
 
+  //------------------------------------------------------------------------------
+  /** \brief Evaluate an expression and its derivative with respect to a variable.
+      \param a_pVar Pointer to the variable the derivative is taken against
+      \param [out] a_pDiff Pointer to the array containing the derivatives of all results
+      \param [out] nStackSize The total number of results available
+      \return Pointer to the array containing all expression results, or NULL if
+              the expression uses an operator or a function that can't be derived
+
+      Forward mode automatic differentiation: every value of the bytecode stack is
+      paired with its derivative, so a single pass gives both. Derivatives of
+      functions are given by #DiffFun.
+  */
+  value_type* ParserBase::EvalDerivative(const value_type *a_pVar, value_type **a_pDiff, int &nStackSize) const
+  {
+    // Create the bytecode without evaluating the expression
+    if (m_pParseFormula==&ParserBase::ParseString)
+    {
+      try
+      {
+        CreateRPN();
+        m_pParseFormula = &ParserBase::ParseCmdCode;
+      }
+      catch(ParserError &exc)
+      {
+        exc.SetFormula(m_pTokenReader->GetExpr());
+        throw;
+      }
+    }
+
+    if (m_vDiffStackBuffer.size()!=m_vStackBuffer.size())
+      m_vDiffStackBuffer.resize(m_vStackBuffer.size());
+
+    value_type *Stack = &m_vStackBuffer[0];
+    value_type *Diff  = &m_vDiffStackBuffer[0];
+    value_type buf, fDiff;
+    int sidx(0);
+    for (const SToken *pTok = m_vRPN.GetBase(); pTok->Cmd!=cmEND ; ++pTok)
+    {
+      switch (pTok->Cmd)
+      {
+      // comparisons are piecewise constant
+      case  cmLE:   --sidx; Stack[sidx]  = Stack[sidx] <= Stack[sidx+1]; Diff[sidx] = 0; continue;
+      case  cmGE:   --sidx; Stack[sidx]  = Stack[sidx] >= Stack[sidx+1]; Diff[sidx] = 0; continue;
+      case  cmNEQ:  --sidx; Stack[sidx]  = Stack[sidx] != Stack[sidx+1]; Diff[sidx] = 0; continue;
+      case  cmEQ:   --sidx; Stack[sidx]  = Stack[sidx] == Stack[sidx+1]; Diff[sidx] = 0; continue;
+      case  cmLT:   --sidx; Stack[sidx]  = Stack[sidx] < Stack[sidx+1];  Diff[sidx] = 0; continue;
+      case  cmGT:   --sidx; Stack[sidx]  = Stack[sidx] > Stack[sidx+1];  Diff[sidx] = 0; continue;
+      case  cmLAND: --sidx; Stack[sidx]  = Stack[sidx] && Stack[sidx+1]; Diff[sidx] = 0; continue;
+      case  cmLOR:  --sidx; Stack[sidx]  = Stack[sidx] || Stack[sidx+1]; Diff[sidx] = 0; continue;
+
+      case  cmADD:  --sidx; Stack[sidx] += Stack[1+sidx]; Diff[sidx] += Diff[1+sidx]; continue;
+      case  cmSUB:  --sidx; Stack[sidx] -= Stack[1+sidx]; Diff[sidx] -= Diff[1+sidx]; continue;
+      case  cmMUL:  --sidx;
+                    Diff[sidx]   = Diff[sidx] * Stack[1+sidx] + Stack[sidx] * Diff[1+sidx];
+                    Stack[sidx] *= Stack[1+sidx];
+                    continue;
+      case  cmDIV:  --sidx;
+
+  #if defined(MUP_MATH_EXCEPTIONS)
+                  if (Stack[1+sidx]==0)
+                    Error(ecDIV_BY_ZERO);
+  #endif
+                  Diff[sidx]   = (Diff[sidx] * Stack[1+sidx] - Stack[sidx] * Diff[1+sidx]) / (Stack[1+sidx] * Stack[1+sidx]);
+                  Stack[sidx] /= Stack[1+sidx];
+                  continue;
+
+      case  cmPOW:
+              --sidx;
+              buf = MathImpl<value_type>::Pow(Stack[sidx], Stack[1+sidx]);
+              if (Diff[1+sidx]==0)
+                Diff[sidx] = (Diff[sidx]==0) ? 0 : Stack[1+sidx] * MathImpl<value_type>::Pow(Stack[sidx], Stack[1+sidx] - 1) * Diff[sidx];
+              else if (Stack[sidx]>0)
+                Diff[sidx] = buf * (Diff[1+sidx] * MathImpl<value_type>::Log(Stack[sidx]) + Stack[1+sidx] * Diff[sidx] / Stack[sidx]);
+              else
+                return NULL;
+              Stack[sidx] = buf;
+              continue;
+
+      case  cmIF:
+            if (Stack[sidx--]==0)
+              pTok += pTok->Oprt.offset;
+            continue;
+
+      case  cmELSE:
+            pTok += pTok->Oprt.offset;
+            continue;
+
+      case  cmENDIF:
+            continue;
+
+      // value and variable tokens
+      case  cmVAR:    Stack[++sidx] = *pTok->Val.ptr;
+                      Diff[sidx]    = (pTok->Val.ptr==a_pVar) ? 1 : 0;
+                      continue;
+      case  cmVAL:    Stack[++sidx] = pTok->Val.data2;
+                      Diff[sidx]    = 0;
+                      continue;
+
+      case  cmVARPOW2: buf = *pTok->Val.ptr;
+                       Stack[++sidx] = buf*buf;
+                       Diff[sidx]    = (pTok->Val.ptr==a_pVar) ? 2*buf : 0;
+                       continue;
+
+      case  cmVARPOW3: buf = *pTok->Val.ptr;
+                       Stack[++sidx] = buf*buf*buf;
+                       Diff[sidx]    = (pTok->Val.ptr==a_pVar) ? 3*buf*buf : 0;
+                       continue;
+
+      case  cmVARPOW4: buf = *pTok->Val.ptr;
+                       Stack[++sidx] = buf*buf*buf*buf;
+                       Diff[sidx]    = (pTok->Val.ptr==a_pVar) ? 4*buf*buf*buf : 0;
+                       continue;
+
+      case  cmVARMUL:  Stack[++sidx] = *pTok->Val.ptr * pTok->Val.data + pTok->Val.data2;
+                       Diff[sidx]    = (pTok->Val.ptr==a_pVar) ? pTok->Val.data : 0;
+                       continue;
+
+      // Numeric functions with a known derivative
+      case  cmFUNC:
+            {
+              int iArgCount = pTok->Fun.argc;
+              if (iArgCount==0)
+              {
+                sidx += 1;
+                Stack[sidx] = (*(fun_type0)pTok->Fun.ptr)();
+                Diff[sidx]  = 0;
+                continue;
+              }
+
+              sidx -= ((iArgCount>0) ? iArgCount : -iArgCount) - 1;
+              if (!DiffFun(pTok->Fun.ptr, iArgCount, &Stack[sidx], &Diff[sidx], fDiff))
+                return NULL;
+
+              switch(iArgCount)
+              {
+              case 1:  Stack[sidx] = (*(fun_type1)pTok->Fun.ptr)(Stack[sidx]); break;
+              case 2:  Stack[sidx] = (*(fun_type2)pTok->Fun.ptr)(Stack[sidx], Stack[sidx+1]); break;
+              default:
+                if (iArgCount>0)
+                  return NULL;
+                Stack[sidx] = (*(multfun_type)pTok->Fun.ptr)(&Stack[sidx], -iArgCount);
+                break;
+              }
+              Diff[sidx] = fDiff;
+              continue;
+            }
+
+      // Assignments, string and bulk functions are not derived
+      default:
+            return NULL;
+      } // switch CmdCode
+    } // for all bytecode tokens
+
+    nStackSize = m_nFinalResultIdx;
+
+    // (for historic reasons the stack starts at position 1)
+    *a_pDiff = &m_vDiffStackBuffer[1];
+    return &m_vStackBuffer[1];
+  }
+
+  //------------------------------------------------------------------------------
+  /** \brief Derivative of a numeric function, used by #EvalDerivative.
+      \param a_pFun The function callback
+      \param a_iArgc Number of arguments, negative for functions with a variable number of arguments
+      \param a_fArg The function arguments
+      \param a_fDiff The derivatives of the function arguments
+      \param [out] a_fResult The derivative of the function
+      \return false if the derivative of the function is not known
+  */
+  bool ParserBase::DiffFun(generic_fun_type, int, const value_type*, const value_type*, value_type&) const
+  {
+    return false;
+  }
+
   //---------------------------------------------------------------------------
   /** \brief Return the number of results on the calculation stack.
 
@@ -107,6 +107,7 @@ private:
 	  value_type  Eval() const;
     value_type* Eval(int &nStackSize) const;
     void Eval(value_type *results, int nBulkSize);
+    value_type* EvalDerivative(const value_type *a_pVar, value_type **a_pDiff, int &nStackSize) const;
 
     int GetNumResults() const;
 
@@ -188,6 +189,11 @@ private:
     virtual void InitOprt() = 0;
 
     virtual void OnDetectVar(string_type *pExpr, int &nStart, int &nEnd);
+    virtual bool DiffFun(generic_fun_type a_pFun,
+                         int a_iArgc,
+                         const value_type *a_fArg,
+                         const value_type *a_fDiff,
+                         value_type &a_fResult) const;
 
     static const char_type *c_DefaultOprt[];
     static std::locale s_locale;  ///< The locale used by the parser
@@ -308,6 +314,7 @@ private:
 
     // items merely used for caching state information
     mutable valbuf_type m_vStackBuffer; ///< This is merely a buffer used for the stack in the cmd parsing routine
+    mutable valbuf_type m_vDiffStackBuffer; ///< Derivatives of the stack values, used by EvalDerivative
     mutable int m_nFinalResultIdx;
 };
 
@@ -220,7 +220,7 @@ void UiInspector::addInterfaces() {
             ui->ssTabConfigArduinoLayout->addWidget(interfacesIterator.value());
         else if(interfacesIterator.key() == MessagesTypeMidi)
             ui->ssTabConfigMIDILayout->addWidget(interfacesIterator.value());
-        else if((interfacesIterator.key() == MessagesTypeOsc) || (interfacesIterator.key() == MessagesTypeUdp) || (interfacesIterator.key() == MessagesTypeTcp) || (interfacesIterator.key() == MessagesTypeHttp))
+        else if((interfacesIterator.key() == MessagesTypeOsc) || (interfacesIterator.key() == MessagesTypeUdp) || (interfacesIterator.key() == MessagesTypeTcp) || (interfacesIterator.key() == MessagesTypeHttp) || (interfacesIterator.key() == MessagesTypeArtnet))
             ui->ssTabConfigNetworkLayout->addWidget(interfacesIterator.value());
         else if((interfacesIterator.key() == MessagesTypeSyphon) || (interfacesIterator.key() == MessagesTypeDirect))
             ui->ssTabConfigSyphonLayout->addWidget(interfacesIterator.value());
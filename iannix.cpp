@@ -58,6 +58,7 @@ IanniX::IanniX(const QString &_projectToLoad, QObject *parent) :
     isGroupSoloActive  = false;
     isObjectSoloActive = false;
     waitingForMessageValue = false;
+    commandApplied = false;
     scriptDir = QDir::current();
 
     //Create basic workspace
@@ -129,6 +130,7 @@ IanniX::IanniX(const QString &_projectToLoad, QObject *parent) :
     MessageManager::addNetworkInterface(MessagesTypeHttp,   new InterfaceHttp  ());
     MessageManager::addNetworkInterface(MessagesTypeSerial, new InterfaceSerial());
     MessageManager::addNetworkInterface(MessagesTypeMidi,   new InterfaceMidi  ());
+    MessageManager::addNetworkInterface(MessagesTypeArtnet, new InterfaceArtnet());
 #ifdef SYPHON_INSTALLED
     MessageManager::addNetworkInterface(MessagesTypeSyphon, render->interfaceSyphon);
 #endif
@@ -159,6 +161,11 @@ IanniX::IanniX(const QString &_projectToLoad, QObject *parent) :
     UiOptions::add(&Application::defaultMessageSync,      "defaultMessageSync");
     UiOptions::add(&Application::defaultMessageTransport, "defaultMessageTransport");
     UiOptions::add(&Application::defaultMessageTrigger,   "defaultMessageTrigger");
+    UiOptions::add(&MessageSender::dropPolicy,            "messageQueueDropPolicy");
+    UiOptions::add(&NxCurveVectorizer::pointsBudget,      "imagePointsBudget");
+    UiOptions::add(&InterfaceMidi::bandwidth,             "midiBandwidth");
+    UiOptions::add(&InterfaceMidi::mtcFps,                "midiMtcFps");
+    UiOptions::add(&UiRenderCapture::encoder,             "captureEncoder");
     NxDocument::restoreDefaults();
 
 
@@ -265,32 +272,26 @@ void IanniX::readyToStart() {
 
 void IanniX::actionImportSVG(const QString &filename) {
     qreal scale = 0.01;
-    QDomDocument xmlDoc;
-    QFile svgFile(filename);
-    if(svgFile.open(QFile::ReadOnly)) {
+    QVector<NxCurveImportItem> items;
+    if(NxCurveImport::readSVG(filename, items)) {
         render->selectionClear(true);
-        xmlDoc.setContent(svgFile.readAll());
-        actionImportSVG(xmlDoc.documentElement(), scale);
-        svgFile.close();
-        inspector->showSpaceTab();
-    }
-}
-void IanniX::actionImportSVG(const QDomElement &xmlElement, qreal scale) {
-    QDomNode xmlNode = xmlElement.firstChild();
-    while(!xmlNode.isNull()) {
-        QDomElement xmlData = xmlNode.toElement();
-        if((!xmlData.isNull()) && (xmlData.tagName() == "path")) {
+        pushSnapshot();
+
+        //Parsing on worker threads, then curves are created in one pass
+        NxCurveImport::parse(items, scale);
+        NxDocument *document = getCurrentDocument();
+        foreach(const NxCurveImportItem &item, items) {
+            if(item.path.elementCount() == 0)
+                continue;
             quint16 id = execute(QString(COMMAND_ADD) + " curve auto", ExecuteSourceGui).toUInt();
-            execute(QString(COMMAND_CURVE_PATH) + " " + QString::number(id) + " " + QString::number(scale) + " " + xmlData.attribute("d"), ExecuteSourceGui);
-            render->selectionAdd(getCurrentDocument()->getObject(id));
-        }
-        else if((!xmlData.isNull()) && (xmlData.tagName() == "polyline")) {
-            quint16 id = execute(QString(COMMAND_ADD) + " curve auto", ExecuteSourceGui).toUInt();;
-            execute(QString(COMMAND_CURVE_LINES) + " " + QString::number(id) + " " + QString::number(scale) + " " + xmlData.attribute("points"), ExecuteSourceGui);
-            render->selectionAdd(getCurrentDocument()->getObject(id));
+            NxObject *object = document->getObject(id);
+            if((object) && (object->getType() == ObjectsTypeCurve)) {
+                ((NxCurve*)object)->setPath(item.path, true);
+                ((NxCurve*)object)->calcBoundingRect();
+                render->selectionAdd(object);
+            }
         }
-        actionImportSVG(xmlData, scale);
-        xmlNode = xmlNode.nextSibling();
+        inspector->showSpaceTab();
     }
 }
 void IanniX::actionImportBackground(const QString &filename) {
@@ -328,7 +329,7 @@ void IanniX::actionImportText(const QString &font, const QString &text) {
 
 
 void IanniX::setScheduler(SchedulerActivity _schedulerActivity) {
-    MessageManager::messagesCache.clear();
+    MessageManager::clearMessagesCache();
     schedulerActivity = _schedulerActivity;
     if(schedulerActivity != SchedulerOff) {
         Transport::timerOk = true;
@@ -383,6 +384,8 @@ void IanniX::timerTick(qreal delta) {
         if(schedulerActivity == SchedulerOneShot)
             setScheduler(SchedulerOff);
     }
+    //Phase lock on an external clock (MIDI slave)
+    delta *= Transport::syncSpeed;
     Transport::timeLocal += delta * Transport::scoreSpeed;
     if(Transport::timeLocal < 0) {
         Transport::forceTimeLocal = true;
@@ -654,6 +657,65 @@ void IanniX::loadProject(const QString & _projectFile) {
         inspector->getFileWidget()->askNew();
     projectIsLoaded = true;
 }
+void IanniX::benchmark(const QString &path, qreal duration, qreal tick) {
+    //Headless replay at a fixed tick, the scheduler timer is not used
+    timer->stop();
+    Benchmark::enabled = true;
+    qDebug("Benchmark of %s (%.1f s at %.1f ms per tick)", qPrintable(path), duration, tick * 1000);
+
+    QFileInfoList scores = QDir(path).entryInfoList(QStringList() << "*.iannix", QDir::Files, QDir::Name);
+    foreach(const QFileInfo &score, scores) {
+        openScore(score);
+
+        //Rewind
+        forceGoto(0);
+        timerTick((qreal)0);
+
+        //Replay
+        Benchmark::start();
+        quint32 ticks = duration / tick;
+        for(quint32 tickIndex = 0 ; tickIndex < ticks ; tickIndex++) {
+            Benchmark::tickStart();
+            timerTick(tick);
+            Benchmark::tickStop();
+        }
+        qDebug("%s", qPrintable(Benchmark::report(score.baseName())));
+    }
+    Benchmark::enabled = false;
+}
+void IanniX::exportFrames(const QString &path, const QString &folder, qreal duration, qreal fps, const QSize &size) {
+    //Offline rendering at a fixed virtual timestep, the scheduler timer is not used
+    timer->stop();
+    Benchmark::enabled = true;
+    qDebug("Export of %s to %s (%.1f s at %.1f fps, %dx%d)", qPrintable(path), qPrintable(folder), duration, fps, size.width(), size.height());
+    openScore(QFileInfo(path));
+    forceGoto(0);
+    timerTick((qreal)0);
+
+    //The score is still scheduled every 5 ms between two frames
+    qreal tick = 1. / fps;
+    quint16 ticksPerFrame = qMax(1, qCeil(tick / 0.005));
+    quint32 frames = duration * fps;
+    for(quint32 frameIndex = 0 ; frameIndex < frames ; frameIndex++) {
+        render->captureFrame(size, QString("%1/Image_%2.png").arg(folder).arg(frameIndex, 5, 10, QChar('0')));
+        for(quint16 tickIndex = 0 ; tickIndex < ticksPerFrame ; tickIndex++)
+            timerTick(tick / ticksPerFrame);
+    }
+    qDebug("Export done (%d frames)", frames);
+    Benchmark::enabled = false;
+}
+void IanniX::openScore(const QFileInfo &score) {
+    //Load the score without the file browser
+    if(currentDocument) {
+        currentDocument->clear();
+        delete currentDocument;
+    }
+    NxDocument *document = new NxDocument(this);
+    document->setHiddenFilename(score);
+    setCurrentDocument(document);
+    render->setDocument(document);
+    document->askFileOpen();
+}
 
 
 void IanniX::setCurrentDocument(NxDocument *_currentDocument) {
@@ -795,18 +857,49 @@ const QVariant IanniX::execute(const MessageIncomming &command, bool createNewOb
     return execute(command.command, ExecuteSourceNetwork, createNewObjectIfExists, needOutput);
 }
 const QVariant IanniX::execute(const QString &command, ExecuteSource source, bool createNewObjectIfExists, bool needOutput) {
+    //References are resolved before the command can change them
+    QList<QStringList> changes;
+    QStringList argv = getWorkingDocument()->resolveReferences(command.split(" ", QString::SkipEmptyParts));
+    if((render) && (argv.count() > 1) && (argv.at(1).toLower() == "selection")) {
+        foreach(const NxObject *object, *render->getSelection()) {
+            argv[1] = QString::number(object->getId());
+            changes.append(argv);
+        }
+    }
+    else
+        changes.append(argv);
+
+    //Nested commands keep the state of their caller
+    bool commandAppliedParent = commandApplied;
+    commandApplied = false;
+    const QVariant retour = executeCommand(command, source, createNewObjectIfExists, needOutput);
+
+    //Only edits that went through are recorded
+    if(commandApplied) {
+        NxDocument *document = getWorkingDocument();
+        foreach(const QStringList &change, changes)
+            document->addChange(change);
+    }
+    commandApplied = commandAppliedParent;
+    return retour;
+}
+const QVariant IanniX::executeCommand(const QString &command, ExecuteSource source, bool createNewObjectIfExists, bool needOutput) {
     //qDebug("=> (%d) %s", source, qPrintable(command));
 
     if(((source == ExecuteSourceGui) || (source == ExecuteSourceInformative)) && (view->help))
         view->help->messageHelp(command);
-    if(source == ExecuteSourceInformative)
+    NxDocument *document = getWorkingDocument();
+    QStringList argv = command.split(" ", QString::SkipEmptyParts);
+    quint16 argc = argv.count();
+
+    //Edits already done in the GUI are only recorded
+    if(source == ExecuteSourceInformative) {
+        commandApplied = true;
         return QVariant();
+    }
 
     NxObjectDispatchProperty::source = source;
-    NxDocument *document = getWorkingDocument();
 
-    QStringList argv = command.split(" ", QString::SkipEmptyParts);
-    quint16 argc = argv.count();
     if(argc > 0) {
         QString commande = argv.at(0).toLower();
         if((argc > 2) && (commande == COMMAND_ADD)) {
@@ -850,6 +943,9 @@ const QVariant IanniX::execute(const QString &command, ExecuteSource source, boo
                 }
                 document->objects[id] = object;
                 document->setCurrentObject(object);
+                document->addChange(QStringList() << COMMAND_ADD << type << QString::number(id));
+                if((parentObject) && (object->getType() == ObjectsTypeCursor))
+                    document->addChange(QStringList() << COMMAND_CURSOR_CURVE << QString::number(id) << QString::number(parentObject->getId()));
                 return object->getId();
             }
             return 0;
@@ -934,6 +1030,7 @@ const QVariant IanniX::execute(const QString &command, ExecuteSource source, boo
 
             //Other type
             else if((commande == COMMAND_TEXTURE) && (argc > 1)) {
+                commandApplied = true;
                 if((argc > 6) && (currentDocument == workingDocument)) {
                     QString filename = argvFullString(command, argv, 6);
                     if((!QFile().exists(filename)) && (document->fileItem))
@@ -944,11 +1041,13 @@ const QVariant IanniX::execute(const QString &command, ExecuteSource source, boo
                     return render->removeTexture(argv.at(1).trimmed());
             }
             else if((commande == COMMAND_GLOBAL_COLOR) && (argc > 5)) {
+                commandApplied = true;
                 if(currentDocument == workingDocument)
                     Render::colors->insert(argv.at(1), QColor(argvDouble(argv, 2), argvDouble(argv, 3), argvDouble(argv, 4), argvDouble(argv, 5)));
                 return Render::colors->update();
             }
             else if((commande == COMMAND_GLOBAL_COLOR_HUE) && (argc > 5)) {
+                commandApplied = true;
                 QColor color;
                 color.setHsv(argvDouble(argv, 2), argvDouble(argv, 3), argvDouble(argv, 4), argvDouble(argv, 5));
                 if(currentDocument == workingDocument)
@@ -1073,6 +1172,7 @@ const QVariant IanniX::execute(const QString &command, ExecuteSource source, boo
                 sleep.wait(&mutex, argvDouble(argv, 1));
             }
             else if(commande == COMMAND_CLEAR) {
+                commandApplied = true;
                 document->pushSnapshot();
                 document->clear();
             }
@@ -1098,6 +1198,7 @@ const QVariant IanniX::execute(const QString &command, ExecuteSource source, boo
                 NxObjectDispatchProperty *object = getObject(argv.at(1));
 
                 if(object) {
+                    commandApplied = true;
                     //String parameter
                     if((commande == COMMAND_GROUP) || (commande == COMMAND_RESIZE) || (commande == COMMAND_POS) || (commande == COMMAND_POS_TRANSLATE) || (commande == COMMAND_LABEL) || (commande == COMMAND_CURSOR_BOUNDS_SOURCE) || (commande == COMMAND_CURSOR_BOUNDS_TARGET) || (commande == COMMAND_CURVE_EQUATION_PARAM) || (commande == COMMAND_CURVE_EQUATION_PARAM_LIST) || (commande == COMMAND_COLOR_ACTIVE) || (commande == COMMAND_COLOR_INACTIVE) || (commande == COMMAND_COLOR_ACTIVE_HUE) || (commande == COMMAND_COLOR_INACTIVE_HUE) || (commande == COMMAND_COLOR_MULTIPLY) || (commande == COMMAND_COLOR_MULTIPLY_HUE) || (commande == COMMAND_MESSAGE) || (commande == COMMAND_CURVE_ELL) || (commande == COMMAND_CURVE_POINT_SHIFT) || (commande == COMMAND_CURVE_POINT_TRANSLATE) || (commande == COMMAND_CURVE_POINT_TRANSLATE2) || (commande == COMMAND_CURVE_EQUATION) || (commande == COMMAND_TEXTURE_ACTIVE) || (commande == COMMAND_TEXTURE_INACTIVE) || (commande == COMMAND_LINE) || (commande == COMMAND_CURSOR_OFFSET) || (commande == COMMAND_CURSOR_START) || (commande == COMMAND_CURSOR_SPEED) || (commande == COMMAND_CURSOR_FIRE)) {
                         if(argc > 2)    object->dispatchProperty(qPrintable(commande), argvFullString(command, argv, 2));
@@ -49,6 +49,8 @@
 #include "gui/uiinspector.h"
 #include "gui/uihelp.h"
 #include "messages/messagemanager.h"
+#include "misc/benchmark.h"
+#include "objects/nxcurveimport.h"
 #include "interfaces/interfacesyphon.h"
 #include "interfaces/interfacedirect.h"
 #include "interfaces/interfacehttp.h"
@@ -57,6 +59,7 @@
 #include "interfaces/interfaceserial.h"
 #include "interfaces/interfacetcp.h"
 #include "interfaces/interfaceudp.h"
+#include "interfaces/interfaceartnet.h"
 #ifdef WACOM_INSTALLED
 #include "interfaces/extwacommanager.h"
 #endif
@@ -107,6 +110,12 @@ public:
     void* getObjectById(quint16 id) {
         return getWorkingDocument()->getObject(id);
     }
+    void* getGroupById(const QString &groupId) {
+        return getWorkingDocument()->getGroup(groupId);
+    }
+    const QString getChangesSince(quint32 since) {
+        return getCurrentDocument()->getChangesSince(since);
+    }
 
 public:
     inline NxObjectDispatchProperty* getObject(const QString & objectIdStr, bool saveObject = true) const {
@@ -140,6 +149,9 @@ private:
     Message message;
     QHash<QByteArray, Message> messagesCache;
     QScriptEngine messageScriptEngine;
+    bool commandApplied;
+private:
+    const QVariant executeCommand(const QString & command, ExecuteSource source, bool createNewObjectIfExists, bool needOutput);
 public slots:
     const QVariant execute(const MessageIncomming & command, bool createNewObjectIfExists = false, bool needOutput = false);
     const QVariant execute(const QString & command, ExecuteSource source, bool createNewObjectIfExists = false, bool needOutput = false);
@@ -170,6 +182,10 @@ public:
     bool projectIsLoaded;
     QString projectToLoad;
     void loadProject(const QString & projectFile = "");
+    void benchmark(const QString &path, qreal duration, qreal tick);
+    void exportFrames(const QString &path, const QString &folder, qreal duration, qreal fps, const QSize &size);
+private:
+    void openScore(const QFileInfo &score);
 
     //TIME MANAGEMENT
 private:
@@ -239,10 +255,6 @@ public slots:
 signals:
     void waitForMessageArrived();
 
-
-    //FAST IMPORT
-public:
-    void actionImportSVG(const QDomElement &xmlElement, qreal scale);
 };
 
 #endif // IANNIX_H
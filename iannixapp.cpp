@@ -36,13 +36,14 @@ int main(int argc, char *argv[]) {
     QTextCodec::setCodecForCStrings(QTextCodec::codecForName("UTF-8"));
 #endif
 
-    IanniXApp iannixApp(argc, argv);
-
 #ifdef QT5
-    qApp->setAttribute(Qt::AA_UseHighDpiPixmaps);
-    qApp->setAttribute(Qt::AA_ShareOpenGLContexts);
+    //Must be set before the application object, otherwise no global share context is created
+    QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
 #endif
 
+    IanniXApp iannixApp(argc, argv);
+
     //QString locale = QLocale::system().name();
     //QTranslator translator;
     //translator.load("Translation_" + locale, "Tools");
@@ -54,14 +55,20 @@ int main(int argc, char *argv[]) {
 #ifdef Q_OS_MAC
     appName += "Mac";
     qDebug("Command line syntax : ./IanniX.app/Contents/MacOS/IanniX <file path>");
+    qDebug("Benchmark syntax    : ./IanniX.app/Contents/MacOS/IanniX -benchmark [seconds] [tick in ms] [scores folder]");
+    qDebug("Export syntax       : ./IanniX.app/Contents/MacOS/IanniX <file path> -export [seconds] [fps] [width x height] [output folder]");
 #endif
 #ifdef Q_OS_WIN
     appName += "Windows";
     qDebug("Command line syntax : IanniX.exe <file path>");
+    qDebug("Benchmark syntax    : IanniX.exe -benchmark [seconds] [tick in ms] [scores folder]");
+    qDebug("Export syntax       : IanniX.exe <file path> -export [seconds] [fps] [width x height] [output folder]");
 #endif
 #ifdef Q_OS_LINUX
     appName += "Linux";
     qDebug("Command line syntax : ./IanniX <file path>");
+    qDebug("Benchmark syntax    : ./IanniX -benchmark [seconds] [tick in ms] [scores folder]");
+    qDebug("Export syntax       : ./IanniX <file path> -export [seconds] [fps] [width x height] [output folder]");
 #endif
 
     QCoreApplication::setApplicationName   (appName.trimmed());
@@ -133,6 +140,39 @@ void IanniXApp::launch(int &argc, char **argv) {
         generateHelp();
     */
 
+    //Benchmark mode : -benchmark [seconds] [tick in ms] [scores folder]
+    qint16 benchmarkIndex = -1;
+    QString benchmarkPath = Application::pathExamples.absoluteFilePath();
+    qreal benchmarkDuration = 60, benchmarkTick = 5;
+    for(quint16 i = 0 ; i < argc ; i++) {
+        if(QString(argv[i]) == "-benchmark")
+            benchmarkIndex = i;
+        else if((benchmarkIndex >= 0) && (i == benchmarkIndex+1) && (QString(argv[i]).toDouble() > 0))
+            benchmarkDuration = QString(argv[i]).toDouble();
+        else if((benchmarkIndex >= 0) && (i == benchmarkIndex+2) && (QString(argv[i]).toDouble() > 0))
+            benchmarkTick = QString(argv[i]).toDouble();
+        else if((benchmarkIndex >= 0) && (i == benchmarkIndex+3) && (QFileInfo(argv[i]).isDir()))
+            benchmarkPath = QFileInfo(argv[i]).absoluteFilePath();
+    }
+
+    //Export mode : <file path> -export [seconds] [fps] [width x height] [output folder]
+    qint16 exportIndex = -1;
+    QString exportPath = Application::pathCurrent.absoluteFilePath();
+    qreal exportDuration = 10, exportFps = 25;
+    QSize exportSize(1920, 1080);
+    for(quint16 i = 0 ; i < argc ; i++) {
+        if(QString(argv[i]) == "-export")
+            exportIndex = i;
+        else if((exportIndex >= 0) && (i == exportIndex+1) && (QString(argv[i]).toDouble() > 0))
+            exportDuration = QString(argv[i]).toDouble();
+        else if((exportIndex >= 0) && (i == exportIndex+2) && (QString(argv[i]).toDouble() > 0))
+            exportFps = QString(argv[i]).toDouble();
+        else if((exportIndex >= 0) && (i == exportIndex+3) && (QString(argv[i]).split("x").count() == 2) && (QString(argv[i]).split("x").at(0).toInt() > 0) && (QString(argv[i]).split("x").at(1).toInt() > 0))
+            exportSize = QSize(QString(argv[i]).split("x").at(0).toInt(), QString(argv[i]).split("x").at(1).toInt());
+        else if((exportIndex >= 0) && (i == exportIndex+4))
+            exportPath = QFileInfo(argv[i]).absoluteFilePath();
+    }
+
     QFileInfo file;
     for(quint16 i = 0 ; i < argc ; i++) {
         file = QFileInfo(argv[i]);
@@ -179,6 +219,15 @@ void IanniXApp::launch(int &argc, char **argv) {
     }
     else
         iannix = new IanniX();
+
+    if(benchmarkIndex >= 0) {
+        iannix->benchmark(benchmarkPath, benchmarkDuration, benchmarkTick / 1000.);
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+    else if((exportIndex >= 0) && (project.exists())) {
+        iannix->exportFrames(project.absoluteFilePath(), exportPath, exportDuration, exportFps, exportSize);
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
 }
 
 bool IanniXApp::event(QEvent *event) {
@@ -207,6 +256,7 @@ void IanniXApp::setHelp() {
     Help::categories["protocols"].infos << HelpInfo(QString("http"),               tr("HTTP request to a webpage/webservice (GET)"));
     Help::categories["protocols"].infos << HelpInfo(QString("udp"),                tr("Raw UDP message (compatible with PureData)"));
     Help::categories["protocols"].infos << HelpInfo(QString("tcp"),                tr("XML over TCP message (compatible with Flash/Director)"));
+    Help::categories["protocols"].infos << HelpInfo(QString("artnet"),             tr("Art-Net DMX channels (artnet://universe/channel)"));
 
     Help::categories["hostIp"].category = tr("Messages IP");
     Help::categories["hostIp"].infos << HelpInfo(QString("ip_out"),                tr("Destination is the default IP set in \"Network\" tab"));
@@ -23,6 +23,7 @@
 
 #include "extscriptvariableask.h"
 #include "ui_extscriptvariableask.h"
+#include "misc/benchmark.h"
 
 ExtScriptVariableAsk::ExtScriptVariableAsk(QWidget *parent) :
         QDialog(parent),
@@ -74,7 +75,7 @@ void ExtScriptVariableAsk::meta(const QString & _title) {
 }
 
 const QList<ExtScriptVariable*> & ExtScriptVariableAsk::ask() {
-    if(variables.count() > 0) {
+    if((variables.count() > 0) && (!Benchmark::enabled)) {
         ui->variablesList->expandAll();
         setWindowTitle(title);
         exec();
@@ -0,0 +1,133 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "interfaceartnet.h"
+#include "ui_interfaceartnet.h"
+
+InterfaceArtnetUniverse::InterfaceArtnetUniverse(quint16 universe) {
+    //ArtDmx header (opcode and universe are little-endian, version and length big-endian)
+    packet = QByteArray(ARTNET_HEADER + ARTNET_CHANNELS, 0);
+    memcpy(packet.data(), "Art-Net", 8);
+    packet[8]  = 0x00;
+    packet[9]  = 0x50;
+    packet[10] = 0;
+    packet[11] = 14;
+    packet[14] = universe & 0xFF;
+    packet[15] = (universe >> 8) & 0x7F;
+    length   = 2;
+    sequence = 0;
+    dirty    = false;
+}
+
+
+InterfaceArtnet::InterfaceArtnet(QWidget *parent) :
+    NetworkInterface(parent),
+    ui(new Ui::InterfaceArtnet) {
+    ui->setupUi(this);
+    socket = new QUdpSocket(this);
+
+    //Interfaces link
+    enable.setAction(ui->enable,           "interfaceArtnetEnable");
+    refreshRate.setAction(ui->refreshRate, "interfaceArtnetRefreshRate");
+    ip.setAction(ui->ip,                   "interfaceArtnetIp");
+    connect(&ip, SIGNAL(triggered(QString)), SLOT(ipChanged()));
+    refreshRate = 40;
+    ip = "255.255.255.255";
+}
+
+void InterfaceArtnet::ipChanged() {
+    if(destination.setAddress(ip.val().trimmed()))  ui->ip->setStyleSheet("");
+    else                                             ui->ip->setStyleSheet("QLineEdit {background: rgb(179, 33, 32);}");
+}
+
+
+bool InterfaceArtnet::send(const Message &message, QStringList *messageSent) {
+    if(!enable)
+        return false;
+
+    //Channel writes accumulate in the universe until the end of the scheduler tick
+    InterfaceArtnetUniverse *universe = universes.value(message.getArtnetUniverse(), 0);
+    if(!universe) {
+        universe = new InterfaceArtnetUniverse(message.getArtnetUniverse());
+        universes.insert(message.getArtnetUniverse(), universe);
+    }
+    const QVector<qreal> &values = message.getValues();
+    quint16 channel = message.getArtnetChannel() - 1;
+    for(quint16 index = 0 ; (index < values.count()) && (channel < ARTNET_CHANNELS) ; index++, channel++) {
+        char value = qBound(0, qRound(values.at(index)), 255);
+        char *data = universe->packet.data() + ARTNET_HEADER + channel;
+        if(*data != value) {
+            *data = value;
+            universe->dirty = true;
+        }
+        //Only the written part of the universe is sent (even length)
+        universe->length = qMax(universe->length, (quint16)((channel + 2) & ~1));
+    }
+
+    //Log in console
+    MessageManager::logSend(message, messageSent);
+
+    return true;
+}
+
+void InterfaceArtnet::networkBundle(bool open) {
+    if(!open)
+        flush();
+}
+void InterfaceArtnet::networkManualParsing() {
+    //Writes made while the transport is stopped, and keep-alive
+    flush();
+}
+
+void InterfaceArtnet::flush() {
+    if((!enable) || (universes.isEmpty()) || (destination.isNull()))
+        return;
+
+    //Refresh rate limit, writes keep accumulating in the meantime
+    if((refreshTimer.isValid()) && (refreshTimer.elapsed() < 1000. / qMax((qreal)1, (qreal)refreshRate)))
+        return;
+    bool keepAlive = (!keepAliveTimer.isValid()) || (keepAliveTimer.elapsed() >= ARTNET_KEEPALIVE);
+
+    //One ArtDmx per dirty universe, every universe once a second
+    bool sent = false;
+    foreach(InterfaceArtnetUniverse *universe, universes) {
+        if((universe->dirty) || (keepAlive)) {
+            universe->sequence = qMax(1, (universe->sequence + 1) & 0xFF);
+            universe->packet[12] = universe->sequence;
+            universe->packet[16] = (universe->length >> 8) & 0xFF;
+            universe->packet[17] = universe->length & 0xFF;
+            socket->writeDatagram(universe->packet.constData(), ARTNET_HEADER + universe->length, destination, ARTNET_UDP_PORT);
+            universe->dirty = false;
+            sent = true;
+        }
+    }
+    if(sent)
+        refreshTimer.start();
+    if(keepAlive)
+        keepAliveTimer.start();
+}
+
+InterfaceArtnet::~InterfaceArtnet() {
+    qDeleteAll(universes);
+    delete ui;
+}
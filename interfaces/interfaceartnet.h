@@ -0,0 +1,82 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INTERFACEARTNET_H
+#define INTERFACEARTNET_H
+
+#include <QWidget>
+#include <QUdpSocket>
+#include <QElapsedTimer>
+#include "misc/options.h"
+#include "messages/messagemanager.h"
+
+#define ARTNET_UDP_PORT  6454
+#define ARTNET_HEADER    18
+#define ARTNET_CHANNELS  512
+#define ARTNET_KEEPALIVE 1000
+
+namespace Ui {
+class InterfaceArtnet;
+}
+
+class InterfaceArtnetUniverse {
+public:
+    QByteArray packet;
+    quint16    length;
+    quint8     sequence;
+    bool       dirty;
+public:
+    explicit InterfaceArtnetUniverse(quint16 universe);
+};
+
+class InterfaceArtnet : public NetworkInterface {
+    Q_OBJECT
+    
+public:
+    explicit InterfaceArtnet(QWidget *parent = 0);
+    ~InterfaceArtnet();
+
+private:
+    UiBool   enable;
+    UiString ip;
+    UiReal   refreshRate;
+private slots:
+    void ipChanged();
+
+private:
+    QUdpSocket   *socket;
+    QHostAddress  destination;
+    QHash<quint16, InterfaceArtnetUniverse*> universes;
+    QElapsedTimer refreshTimer, keepAliveTimer;
+    void flush();
+
+public:
+    bool send(const Message &message, QStringList *messageSent = 0);
+    void networkBundle(bool open);
+    void networkManualParsing();
+
+private:
+    Ui::InterfaceArtnet *ui;
+};
+
+#endif // INTERFACEARTNET_H
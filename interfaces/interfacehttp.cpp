@@ -36,6 +36,18 @@ InterfaceHttp::InterfaceHttp(QWidget *parent) :
     connect(httpServer, SIGNAL(parseRequest(QNetworkReply*)), SLOT(parseRequest(QNetworkReply*)));
     connect(httpServer, SIGNAL(parseSocket(QTcpSocket*)),     SLOT(parseSocket(QTcpSocket*)));
 
+    //Live frames, encoded once per tick for all the streams
+    streamEncoder = new InterfaceHttpEncoder(this);
+    connect(streamEncoder, SIGNAL(encoded()), SLOT(streamEncoded()));
+    connect(&streamTimer,  SIGNAL(timeout()), SLOT(streamTick()));
+
+    //Requests statistics
+    statsRequests = 0;
+    statsLatency = statsLatencyMax = 0;
+    statsTimer.start();
+    connect(&statsRefreshTimer, SIGNAL(timeout()), SLOT(refreshStats()));
+    statsRefreshTimer.start(1000);
+
     //Websockets server
     webSocketServer = new WebSocketServer(this);
     connect(webSocketServer, SIGNAL(newConnection()), SLOT(webSocketsNewConnection()));
@@ -58,7 +70,8 @@ InterfaceHttp::InterfaceHttp(QWidget *parent) :
 }
 
 InterfaceHttpServer::InterfaceHttpServer(QObject *parent) :
-    QTcpServer(parent) {
+    QTcpServer(parent), stats("HTTP") {
+    httpPending = 0;
     http = new QNetworkAccessManager(this);
     connect(http, SIGNAL(finished(QNetworkReply*)), SLOT(parse(QNetworkReply*)));
 }
@@ -91,6 +104,19 @@ void InterfaceHttp::webSocketsNewConnection() {
 void InterfaceHttp::webSocketsProcessMessage(const QString &message) {
     WebSocket *webSocket = qobject_cast<WebSocket *>(sender());
     if(webSocket) {
+        //Push channel subscriptions
+        if((message.startsWith("subscribe")) || (message.startsWith("unsubscribe"))) {
+            QStringList items = message.split(" ", QString::SkipEmptyParts);
+            bool add = (items.takeFirst() == "subscribe");
+            webSocketsPush(webSocket)->subscribe(items, add);
+            return;
+        }
+        //Differential sync
+        if(message.startsWith("changes")) {
+            webSocket->send(Application::current->getChangesSince(message.mid(7).trimmed().toUInt()));
+            return;
+        }
+
         QStringList commandItems = message.split(COMMAND_END, QString::SkipEmptyParts);;
         QString response;
         foreach(const QString & command, commandItems)
@@ -99,15 +125,31 @@ void InterfaceHttp::webSocketsProcessMessage(const QString &message) {
             webSocket->send(response);
     }
 }
-void InterfaceHttp::webSocketsProcessBinaryMessage(const QByteArray &) {
+void InterfaceHttp::webSocketsProcessBinaryMessage(const QByteArray &message) {
     WebSocket *webSocket = qobject_cast<WebSocket *>(sender());
-    if(webSocket) {
+    if(webSocket)
+        webSocketsPush(webSocket)->subscribe(message);
+}
+InterfaceHttpPush* InterfaceHttp::webSocketsPush(WebSocket *webSocket) {
+    InterfaceHttpPush *push = webSocketPushes.value(webSocket, 0);
+    if(!push) {
+        push = new InterfaceHttpPush(webSocket);
+        webSocketPushes.insert(webSocket, push);
     }
+    return push;
+}
+void InterfaceHttp::networkBundle(bool start) {
+    //End of a scheduler tick: delta frames for the subscribed clients
+    if((!start) && (enable))
+        foreach(InterfaceHttpPush *push, webSocketPushes)
+            if(!push->isEmpty())
+                push->push();
 }
 void InterfaceHttp::webSocketsSocketDisconnected() {
     WebSocket *webSocket = qobject_cast<WebSocket *>(sender());
     if(webSocket) {
         webSocketClients.removeAll(webSocket);
+        delete webSocketPushes.take(webSocket);
         webSocket->deleteLater();
     }
     webSocketsUpdateConnectedClients();
@@ -132,8 +174,17 @@ bool InterfaceHttp::send(const Message &message, QStringList *messageSent) {
     return httpServer->send(message, messageSent);
 }
 bool InterfaceHttpServer::send(const Message &message, QStringList *messageSent) {
+    //Unresponsive endpoints, too many requests are still waiting for a reply
+    if(httpPending >= INTERFACE_HTTP_PENDING_MAX) {
+        stats.dropped++;
+        return false;
+    }
+
     //Send request
     http->get(QNetworkRequest(message.getUrlMessage()));
+    httpPending++;
+    stats.queued++;
+    stats.setDepth(httpPending);
 
     //Log in console
     MessageManager::logSend(message, messageSent);
@@ -143,7 +194,11 @@ bool InterfaceHttpServer::send(const Message &message, QStringList *messageSent)
 
 
 void InterfaceHttpServer::parse(QNetworkReply *reply) {
+    if(httpPending)
+        httpPending--;
+    stats.sent.fetchAndAddRelaxed(1);
     emit(parseRequest(reply));
+    reply->deleteLater();
 }
 void InterfaceHttp::parseRequest(QNetworkReply *reply) {
     if(!enable)
@@ -173,97 +228,316 @@ void InterfaceHttpServer::incomingConnection(qintptr handle) {
 #endif
 void InterfaceHttpServer::readClient() {
     QTcpSocket *socket = (QTcpSocket*)sender();
-    if(socket->canReadLine())
+    if(socket->bytesAvailable())
         emit(parseSocket(socket));
 }
 void InterfaceHttp::parseSocket(QTcpSocket *socket) {
     if(!enable)
         return;
 
-    QStringList tokens = QString(socket->readLine()).split(QRegExp("[ \r\n][ \r\n]*"));
-    if((tokens.count() > 1) && (tokens.at(0) == "GET")) {
-        QUrl url(tokens.at(1));
+    //Per-connection state, a request being processed is not parsed again by a re-entrant call
+    InterfaceHttpRequest *request = requests.value(socket, 0);
+    if(!request) {
+        request = new InterfaceHttpRequest();
+        requests.insert(socket, request);
+        connect(socket, SIGNAL(destroyed(QObject*)), SLOT(socketDestroyed(QObject*)));
+    }
+    else if(request->busy)
+        return;
 
-        QList<QString> commands;
-        QPair<QString,qint8> picFormat;
-        picFormat.first = "png";
-        picFormat.second = -1;
-        bool isPic = false, isSync = false;
+    //Incremental parsing, several pipelined requests can be waiting in the buffer
+    while(true) {
+        if(request->state == InterfaceHttpRequest::RequestLine) {
+            if(!socket->canReadLine())
+                return;
+            QList<QByteArray> tokens = socket->readLine().trimmed().split(' ');
+            if(tokens.count() < 2)
+                continue;
+            request->timer.start();
+            request->method    = tokens.at(0).toUpper();
+            request->target    = tokens.at(1);
+            request->keepAlive = (tokens.count() > 2) && (tokens.at(2).toUpper() == "HTTP/1.1");
+            request->http11    = request->keepAlive;
+            request->contentLength = 0;
+            request->state = InterfaceHttpRequest::Headers;
+        }
+        if(request->state == InterfaceHttpRequest::Headers) {
+            while(request->state == InterfaceHttpRequest::Headers) {
+                if(!socket->canReadLine())
+                    return;
+                QByteArray header = socket->readLine().trimmed();
+                if(header.isEmpty())
+                    request->state = InterfaceHttpRequest::Body;
+                else {
+                    int separator = header.indexOf(':');
+                    QByteArray name = header.left(separator).trimmed().toLower(), value = header.mid(separator+1).trimmed().toLower();
+                    if(name == "content-length")
+                        request->contentLength = value.toLongLong();
+                    else if(name == "connection")
+                        request->keepAlive = (value == "keep-alive") || ((request->http11) && (value != "close"));
+                }
+            }
+        }
+        if(request->state == InterfaceHttpRequest::Body) {
+            if((request->contentLength < 0) || (request->contentLength > INTERFACE_HTTP_BODY_MAX)) {
+                request->keepAlive = false;
+                if(request->contentLength < 0)  reply(socket, *request, "text/plain; charset=\"utf-8\"", "Bad Request\n",       "400 Bad Request");
+                else                            reply(socket, *request, "text/plain; charset=\"utf-8\"", "Payload Too Large\n", "413 Payload Too Large");
+                requests.remove(socket);
+                delete request;
+                socket->disconnectFromHost();
+                return;
+            }
+            if(socket->bytesAvailable() < request->contentLength)
+                return;
+            request->body = socket->read(request->contentLength);
+
+            //Commands can re-enter the event loop and destroy the socket, the request is then freed here
+            QPointer<QTcpSocket> socketGuard(socket);
+            request->busy = true;
+            bool keepOpen = processRequest(socket, *request);
+            request->busy = false;
+            if(!socketGuard) {
+                delete request;
+                return;
+            }
+
+            //Statistics
+            statsRequests++;
+            qint64 latency = request->timer.nsecsElapsed() / 1000;
+            statsLatency   += latency;
+            statsLatencyMax = qMax(statsLatencyMax, latency);
+
+            if((keepOpen) || (!request->keepAlive)) {
+                requests.remove(socket);
+                delete request;
+                if(!keepOpen)
+                    socket->disconnectFromHost();
+                return;
+            }
+            request->state = InterfaceHttpRequest::RequestLine;
+            request->body.clear();
+        }
+    }
+}
+bool InterfaceHttp::processRequest(QTcpSocket *socket, const InterfaceHttpRequest &request) {
+    QUrl url(QString::fromUtf8(request.target));
+
+    QList<QString> commands;
+    QPair<QString,qint8> picFormat;
+    picFormat.first = "png";
+    picFormat.second = -1;
+    qreal picFps = 10;
+    bool isPic = false, isSync = false;
+    QString syncSince;
 #ifdef QT4
-        QList< QPair<QString, QString> > tokens = url.queryItems();
+    QList< QPair<QString, QString> > tokens = url.queryItems();
 #else
-        QList< QPair<QString, QString> > tokens = QUrlQuery(url.query()).queryItems();
+    QList< QPair<QString, QString> > tokens = QUrlQuery(url.query()).queryItems();
 #endif
-        for(quint16 index = 0 ; index < tokens.count() ; index++) {
-            QString first = tokens.at(index).first.toLower();
-            if((first == "png") || (first == "jpg") || (first == "mjpg")) {
-                isPic = true;
-                picFormat.first  = first;
-                picFormat.second = tokens.at(index).second.toInt();
-            }
-            else if(first == "sync")
-                isSync = true;
-            else
-                commands.append(tokens.at(index).second);
+    for(quint16 index = 0 ; index < tokens.count() ; index++) {
+        QString first = tokens.at(index).first.toLower();
+        if((first == "png") || (first == "jpg") || (first == "mjpg")) {
+            isPic = true;
+            picFormat.first  = first;
+            picFormat.second = tokens.at(index).second.toInt();
         }
+        else if(first == "fps")
+            picFps = tokens.at(index).second.toDouble();
+        else if(first == "sync") {
+            isSync = true;
+            syncSince = tokens.at(index).second;
+        }
+        else
+            commands.append(tokens.at(index).second);
+    }
 
-        QTextStream os(socket);
-        if((commands.count() > 0) && (!isPic) && (!isSync)) {
-            os.setAutoDetectUnicode(true);
-            os << "HTTP/1.0 200 Ok\r\n"
-                  "Content-Type: text/plain; charset=\"utf-8\"\r\n"
-                  "Access-Control-Allow-Origin: *\r\n"
-                  "\r\n";
-
-            QString response;
-            foreach(const QString & command, commands)
-                response += MessageManager::incomingMessage(MessageIncomming("http", socket->peerAddress().toString(), socket->peerPort(), url.path(), command, command.split(" ", QString::SkipEmptyParts)), true, (command != "goto")) + "\n";
+    //Batch: newline-delimited commands in the body, all the results in one response
+    if(request.method == "POST")
+        foreach(const QByteArray &command, request.body.split('\n'))
+            if(!command.trimmed().isEmpty())
+                commands.append(QString::fromUtf8(command.trimmed()));
 
-            os << response;
+    if((commands.count() > 0) && (!isPic) && (!isSync)) {
+        QPointer<QTcpSocket> socketGuard(socket);
+        QString peerAddress = socket->peerAddress().toString();
+        quint16 peerPort = socket->peerPort();
+        QString response;
+        foreach(const QString & command, commands) {
+            response += MessageManager::incomingMessage(MessageIncomming("http", peerAddress, peerPort, url.path(), command, command.split(" ", QString::SkipEmptyParts)), true, (command != "goto")) + "\n";
+            if(!socketGuard)
+                return false;
         }
-        else if(isSync) {
-            os.setAutoDetectUnicode(true);
-            os << "HTTP/1.0 200 Ok\r\n"
-                  "Content-Type: text/plain; charset=\"utf-8\"\r\n"
-                  "Access-Control-Allow-Origin: *\r\n"
-                  "\r\n";
-
-            NxObjectDispatchProperty::source = ExecuteSourceCopyPaste;
-            os << Application::current->serialize();
+        reply(socket, request, "text/plain; charset=\"utf-8\"", response.toUtf8());
+    }
+    else if((isSync) && (!syncSince.isEmpty()))
+        reply(socket, request, "text/plain; charset=\"utf-8\"", Application::current->getChangesSince(syncSince.toUInt()).toUtf8());
+    else if(isSync) {
+        NxObjectDispatchProperty::source = ExecuteSourceCopyPaste;
+        reply(socket, request, "text/plain; charset=\"utf-8\"", Application::current->serialize().toUtf8());
+    }
+    else if(isPic) {
+        if((picFormat.first == "png") || (picFormat.first == "jpg")) {
+            QByteArray byteArray;
+            QBuffer buffer(&byteArray);
+            if(picFormat.second == 0)
+                picFormat.second = -1;
+            Application::takeScreenshot().save(&buffer, qPrintable(picFormat.first), picFormat.second);
+            reply(socket, request, (picFormat.first == "png")?("image/png"):("image/jpeg"), byteArray);
         }
-        else if(isPic) {
-            if((picFormat.first == "png") || (picFormat.first == "jpg")) {
-                os << "HTTP/1.0 200 Ok\r\n"
-                      "Content-Type: image/jpeg\r\n"
-                      "Access-Control-Allow-Origin: *\r\n"
-                      "\r\n";
-
-                QByteArray byteArray;
-                QBuffer buffer(&byteArray);
-                if(picFormat.second == 0)
-                    picFormat.second = -1;
-                Application::takeScreenshot().save(&buffer, qPrintable(picFormat.first), picFormat.second);
-
-                os.flush();
-                socket->write(byteArray);
-            }
-            else if(picFormat.first == "mjpg") {
-            }
+        else if(picFormat.first == "mjpg") {
+            socket->write("HTTP/1.0 200 Ok\r\n"
+                          "Content-Type: multipart/x-mixed-replace; boundary=iannixframe\r\n"
+                          "Cache-Control: no-cache\r\n"
+                          "Access-Control-Allow-Origin: *\r\n"
+                          "\r\n");
+
+            //Socket stays open, frames are pushed by streamEncoded()
+            InterfaceHttpStream stream;
+            stream.socket   = socket;
+            stream.quality  = (picFormat.second > 0)?(picFormat.second):(75);
+            stream.interval = 1000 / qBound(1., picFps, 30.);
+            stream.lastFrame.start();
+            streams.append(stream);
+            streamTick();
+            return true;
+        }
+    }
+    else
+        reply(socket, request, "text/html; charset=\"utf-8\"", htmlTemplate.toUtf8());
+    return false;
+}
+void InterfaceHttp::reply(QTcpSocket *socket, const InterfaceHttpRequest &request, const QByteArray &contentType, const QByteArray &content, const QByteArray &status) {
+    QByteArray header;
+    header.reserve(192);
+    header += ((request.http11)?("HTTP/1.1 "):("HTTP/1.0 ")) + status + "\r\n";
+    header += "Content-Type: " + contentType + "\r\n";
+    header += "Content-Length: " + QByteArray::number(content.size()) + "\r\n";
+    header += (request.keepAlive)?("Connection: keep-alive\r\n"):("Connection: close\r\n");
+    header += "Access-Control-Allow-Origin: *\r\n"
+              "\r\n";
+    socket->write(header);
+    socket->write(content);
+}
+void InterfaceHttp::socketDestroyed(QObject *socket) {
+    //A request still being processed is freed by parseSocket()
+    InterfaceHttpRequest *request = requests.take((QTcpSocket*)socket);
+    if((request) && (!request->busy))
+        delete request;
+    for(quint16 index = 0 ; index < streams.count() ; index++) {
+        if(streams.at(index).socket == socket) {
+            streams.removeAt(index);
+            break;
+        }
+    }
+}
+void InterfaceHttp::refreshStats() {
+    //Requests served since the last refresh
+    qreal elapsed = statsTimer.restart() / 1000.;
+    if(statsRequests)
+        ui->serverStats->setText(tr("%1 requests/s, latency %2 ms (max %3 ms)\n%4 connections, %5 streams").arg(statsRequests / elapsed, 0, 'f', 1).arg(statsLatency / statsRequests / 1000., 0, 'f', 2).arg(statsLatencyMax / 1000., 0, 'f', 2).arg(requests.count()).arg(streams.count()));
+    else
+        ui->serverStats->setText(tr("No request\n%1 connections, %2 streams").arg(requests.count()).arg(streams.count()));
+    statsRequests = 0;
+    statsLatency = statsLatencyMax = 0;
+}
+
+void InterfaceHttp::streamTick() {
+    if(streams.isEmpty()) {
+        streamTimer.stop();
+        return;
+    }
+
+    //Timer follows the fastest stream
+    quint16 interval = 1000;
+    QList<qint8> qualities;
+    foreach(const InterfaceHttpStream &stream, streams) {
+        interval = qMin(interval, stream.interval);
+        if(!qualities.contains(stream.quality))
+            qualities.append(stream.quality);
+    }
+    if((!streamTimer.isActive()) || (streamTimer.interval() != interval))
+        streamTimer.start(interval);
+
+    //Grab on the GUI thread, encoding is done by the worker (frame skipped if it is still busy)
+    if(streamEncoder->isBusy())
+        return;
+    streamEncoder->encode(Application::takeScreenshot(), qualities);
+}
+void InterfaceHttp::streamEncoded() {
+    for(quint16 index = 0 ; index < streams.count() ; index++) {
+        InterfaceHttpStream &stream = streams[index];
+        //Clients too slow to read are skipped rather than buffered
+        if((stream.lastFrame.elapsed() < stream.interval) || (stream.socket->bytesToWrite() > INTERFACE_HTTP_STREAM_BUFFER))
+            continue;
+        QByteArray frame = streamEncoder->frame(stream.quality);
+        if(frame.isEmpty())
+            continue;
+        stream.socket->write("--iannixframe\r\nContent-Type: image/jpeg\r\nContent-Length: " + QByteArray::number(frame.size()) + "\r\n\r\n");
+        stream.socket->write(frame);
+        stream.socket->write("\r\n");
+        stream.lastFrame.start();
+    }
+}
+
+InterfaceHttpEncoder::InterfaceHttpEncoder(QObject *parent) :
+    QThread(parent) {
+    busy    = false;
+    running = true;
+    start(QThread::LowPriority);
+}
+InterfaceHttpEncoder::~InterfaceHttpEncoder() {
+    mutex.lock();
+    running = false;
+    condition.wakeAll();
+    mutex.unlock();
+    wait();
+}
+bool InterfaceHttpEncoder::isBusy() {
+    QMutexLocker locker(&mutex);
+    return busy;
+}
+bool InterfaceHttpEncoder::encode(const QImage &_image, const QList<qint8> &_qualities) {
+    QMutexLocker locker(&mutex);
+    if((busy) || (_image.isNull()))
+        return false;
+    image     = _image;
+    qualities = _qualities;
+    busy      = true;
+    condition.wakeAll();
+    return true;
+}
+const QByteArray InterfaceHttpEncoder::frame(qint8 quality) {
+    QMutexLocker locker(&mutex);
+    return frames.value(quality);
+}
+void InterfaceHttpEncoder::run() {
+    mutex.lock();
+    while(running) {
+        if(!busy) {
+            condition.wait(&mutex);
+            continue;
         }
-        else {
-            os.setAutoDetectUnicode(true);
-            os << "HTTP/1.0 200 Ok\r\n"
-                  "Content-Type: text/html; charset=\"utf-8\"\r\n"
-                  "Access-Control-Allow-Origin: *\r\n"
-                  "\r\n";
-
-            os << htmlTemplate;
+        QImage imageToEncode = image;
+        QList<qint8> qualitiesToEncode = qualities;
+        image = QImage();
+        mutex.unlock();
+
+        //One encoded frame per quality, shared by all the streams
+        QHash<qint8, QByteArray> framesEncoded;
+        foreach(qint8 quality, qualitiesToEncode) {
+            QByteArray byteArray;
+            QBuffer buffer(&byteArray);
+            imageToEncode.save(&buffer, "jpg", quality);
+            framesEncoded.insert(quality, byteArray);
         }
 
-        socket->close();
-        if(socket->state() == QTcpSocket::UnconnectedState)
-            delete socket;
+        mutex.lock();
+        frames = framesEncoded;
+        busy   = false;
+        emit(encoded());
     }
+    mutex.unlock();
 }
 void InterfaceHttpServer::discardClient() {
     QTcpSocket* socket = (QTcpSocket*)sender();
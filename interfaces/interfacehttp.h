@@ -33,11 +33,21 @@
 #include <QDir>
 #include <QBuffer>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QTimer>
+#include <QPointer>
 #include "misc/options.h"
 #include "messages/messagemanager.h"
 #include "qwebsockets/websocketserver.h"
 #include "qwebsockets/websocket.h"
+#include "interfacehttppush.h"
 
+#define INTERFACE_HTTP_PENDING_MAX  64
+#define INTERFACE_HTTP_STREAM_BUFFER (2*1024*1024)
+#define INTERFACE_HTTP_BODY_MAX      (4*1024*1024)
 
 namespace Ui {
 class InterfaceHttp;
@@ -51,6 +61,8 @@ public:
 
 private:
     QNetworkAccessManager *http;
+    quint16 httpPending;
+    MessageSenderStats stats;
 
 public:
     bool send(const Message &message, QStringList *messageSent = 0);
@@ -73,6 +85,56 @@ signals:
 
 
 
+class InterfaceHttpEncoder : public QThread {
+    Q_OBJECT
+
+public:
+    explicit InterfaceHttpEncoder(QObject *parent = 0);
+    ~InterfaceHttpEncoder();
+
+private:
+    QMutex mutex;
+    QWaitCondition condition;
+    QImage image;
+    QList<qint8> qualities;
+    QHash<qint8, QByteArray> frames;
+    bool busy, running;
+public:
+    bool isBusy();
+    bool encode(const QImage &_image, const QList<qint8> &_qualities);
+    const QByteArray frame(qint8 quality);
+protected:
+    void run();
+signals:
+    void encoded();
+};
+
+class InterfaceHttpRequest {
+public:
+    enum State { RequestLine, Headers, Body };
+    State         state;
+    QByteArray    method, target, body;
+    bool          http11, keepAlive, busy;
+    qint64        contentLength;
+    QElapsedTimer timer;
+public:
+    explicit InterfaceHttpRequest() {
+        state = RequestLine;
+        http11 = keepAlive = busy = false;
+        contentLength = 0;
+    }
+};
+
+class InterfaceHttpStream {
+public:
+    QTcpSocket   *socket;
+    qint8         quality;
+    quint16       interval;
+    QElapsedTimer lastFrame;
+};
+
+
+
 class InterfaceHttp : public NetworkInterface {
     Q_OBJECT
     
@@ -86,10 +148,30 @@ private slots:
     void portChanged();
     void parseRequest(QNetworkReply*);
     void parseSocket(QTcpSocket*);
+    void socketDestroyed(QObject*);
+    void refreshStats();
+
+private:
+    QHash<QTcpSocket*, InterfaceHttpRequest*> requests;
+    quint32 statsRequests;
+    qint64  statsLatency, statsLatencyMax;
+    QElapsedTimer statsTimer;
+    QTimer statsRefreshTimer;
+    bool processRequest(QTcpSocket *socket, const InterfaceHttpRequest &request);
+    void reply(QTcpSocket *socket, const InterfaceHttpRequest &request, const QByteArray &contentType, const QByteArray &content, const QByteArray &status = "200 Ok");
+
+private:
+    InterfaceHttpEncoder *streamEncoder;
+    QList<InterfaceHttpStream> streams;
+    QTimer streamTimer;
+private slots:
+    void streamTick();
+    void streamEncoded();
 
 private:
     WebSocketServer*  webSocketServer;
     QList<WebSocket*> webSocketClients;
+    QHash<WebSocket*, InterfaceHttpPush*> webSocketPushes;
 private slots:
     void portWebSocketsChanged();
     void webSocketsNewConnection();
@@ -97,6 +179,8 @@ private slots:
     void webSocketsProcessBinaryMessage(const QByteArray &message);
     void webSocketsSocketDisconnected();
     void webSocketsUpdateConnectedClients();
+private:
+    InterfaceHttpPush* webSocketsPush(WebSocket *webSocket);
 
 
 private:
@@ -111,6 +195,7 @@ private slots:
 
 public:
     bool send(const Message &message, QStringList *messageSent = 0);
+    void networkBundle(bool start);
 
 
 private:
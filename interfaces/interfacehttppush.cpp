@@ -0,0 +1,167 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "interfacehttppush.h"
+#include "misc/application.h"
+#include "transport/transport.h"
+#include "objects/nxgroup.h"
+#include "objects/nxcursor.h"
+#include "objects/nxtrigger.h"
+
+InterfaceHttpPush::InterfaceHttpPush(WebSocket *_webSocket) {
+    webSocket = _webSocket;
+    frame = 0;
+}
+
+void InterfaceHttpPush::subscribe(const QStringList &items, bool add) {
+    if((!add) && (items.isEmpty())) {
+        ids.clear();
+        groups.clear();
+    }
+    foreach(const QString &item, items) {
+        bool ok = false;
+        quint16 id = item.toUInt(&ok);
+        if(ok) {
+            if(add) ids.insert(id);
+            else    ids.remove(id);
+        }
+        else {
+            if(add) groups.insert(item);
+            else    groups.remove(item);
+        }
+    }
+    //Next frame is complete for the new subscriptions
+    frame = 0;
+}
+void InterfaceHttpPush::subscribe(const QByteArray &message) {
+    if(message.isEmpty())
+        return;
+    quint8 opcode = message.at(0);
+    if(opcode == OpcodeUnsubscribeAll) {
+        ids.clear();
+        groups.clear();
+    }
+    else {
+        for(quint32 index = 1 ; index + 1 < (quint32)message.size() ; index += 2) {
+            quint16 id = qFromLittleEndian<quint16>((const uchar*)message.constData() + index);
+            if(opcode == OpcodeSubscribe)         ids.insert(id);
+            else if(opcode == OpcodeUnsubscribe)  ids.remove(id);
+        }
+    }
+    frame = 0;
+}
+
+void InterfaceHttpPush::push() {
+    bool keyframe = ((frame % INTERFACE_HTTP_PUSH_KEYFRAME) == 0);
+    buffer.resize(0);
+    append((quint32)frame);
+    append((float)Transport::timeLocal);
+    append((quint16)0);
+
+    //Subscribed objects, each one once
+    QSet<quint16> done;
+    quint16 count = 0;
+    foreach(quint16 id, ids)
+        pushObject(Application::current->getObjectById(id), done, count, keyframe);
+    foreach(const QString &groupId, groups) {
+        NxGroup *group = (NxGroup*)Application::current->getGroupById(groupId);
+        if(group)
+            for(quint8 activityIterator = 0 ; activityIterator < ObjectsActivityLenght ; activityIterator++)
+                for(quint8 typeIterator = 0 ; typeIterator < ObjectsTypeLength ; typeIterator++)
+                    foreach(NxObject *object, group->objects[activityIterator][typeIterator])
+                        pushObject(object, done, count, keyframe);
+    }
+
+    //Objects which disappeared
+    QMutableHashIterator<quint16, QVector<float> > lastIterator(last);
+    while(lastIterator.hasNext()) {
+        lastIterator.next();
+        if(!done.contains(lastIterator.key())) {
+            append((quint16)lastIterator.key());
+            append((quint8)0);
+            append((quint8)0);
+            count++;
+            lastIterator.remove();
+        }
+    }
+
+    frame++;
+    if((count) || (keyframe)) {
+        qToLittleEndian(count, (uchar*)buffer.data() + 8);
+        webSocket->send(buffer);
+    }
+}
+
+void InterfaceHttpPush::pushObject(void *_object, QSet<quint16> &done, quint16 &count, bool keyframe) {
+    NxObject *object = (NxObject*)_object;
+    if((!object) || (done.contains(object->getId())))
+        return;
+    done.insert(object->getId());
+
+    //Current values
+    float values[INTERFACE_HTTP_PUSH_FIELDS];
+    quint8 valuesCount = 3;
+    if(object->getType() == ObjectsTypeCursor) {
+        NxCursor *cursor = (NxCursor*)object;
+        values[0] = cursor->getCurrentPos().x();
+        values[1] = cursor->getCurrentPos().y();
+        values[2] = cursor->getCurrentPos().z();
+        values[3] = cursor->getCurrentValue().x();
+        values[4] = cursor->getCurrentValue().y();
+        values[5] = cursor->getCurrentValue().z();
+        values[6] = cursor->getCurrentAngle().z();
+        valuesCount = 7;
+    }
+    else {
+        values[0] = object->getPos().x();
+        values[1] = object->getPos().y();
+        values[2] = object->getPos().z();
+        if(object->getType() == ObjectsTypeTrigger) {
+            values[3] = ((NxTrigger*)object)->getTrigged();
+            valuesCount = 4;
+        }
+    }
+
+    //Delta against the previous frame sent to this client
+    QVector<float> &previous = last[object->getId()];
+    bool isNew = (previous.count() != valuesCount);
+    if(isNew)
+        previous.resize(valuesCount);
+    quint8 mask = 0;
+    for(quint8 index = 0 ; index < valuesCount ; index++)
+        if((keyframe) || (isNew) || (previous.at(index) != values[index]))
+            mask |= (1 << index);
+    if(!mask)
+        return;
+
+    append((quint16)object->getId());
+    append((quint8)object->getType());
+    append((quint8)mask);
+    for(quint8 index = 0 ; index < valuesCount ; index++) {
+        if(mask & (1 << index)) {
+            append(values[index]);
+            previous[index] = values[index];
+        }
+    }
+    count++;
+}
@@ -0,0 +1,85 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INTERFACEHTTPPUSH_H
+#define INTERFACEHTTPPUSH_H
+
+#include <QSet>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QtEndian>
+#include "qwebsockets/websocket.h"
+
+#define INTERFACE_HTTP_PUSH_KEYFRAME    250
+#define INTERFACE_HTTP_PUSH_FIELDS      7
+
+//Client → server (binary): opcode (1 subscribe, 2 unsubscribe, 3 unsubscribe all) followed by uint16 IDs
+//Client → server (text):   "subscribe 12 14 groupName", "unsubscribe 12", "unsubscribe"
+//Server → client (binary, little-endian): uint32 frame, float32 time, uint16 records count,
+//then per record uint16 ID, uint8 type, uint8 mask of changed fields and one float32 per set bit
+//(cursor: x y z value x y z angle, trigger: x y z trigged, curve: x y z). A zero mask means the object is gone.
+class InterfaceHttpPush {
+public:
+    enum Opcode { OpcodeSubscribe = 1, OpcodeUnsubscribe = 2, OpcodeUnsubscribeAll = 3 };
+
+public:
+    explicit InterfaceHttpPush(WebSocket *_webSocket);
+
+private:
+    WebSocket *webSocket;
+    QSet<quint16> ids;
+    QSet<QString> groups;
+    QHash<quint16, QVector<float> > last;
+    quint32 frame;
+    QByteArray buffer;
+
+public:
+    void subscribe(const QStringList &items, bool add);
+    void subscribe(const QByteArray &message);
+    inline bool isEmpty() const { return (ids.isEmpty()) && (groups.isEmpty()); }
+    void push();
+
+private:
+    void pushObject(void *object, QSet<quint16> &done, quint16 &count, bool keyframe);
+    inline void append(quint8 value) {
+        buffer.append((char)value);
+    }
+    inline void append(quint16 value) {
+        uchar data[2];
+        qToLittleEndian(value, data);
+        buffer.append((const char*)data, 2);
+    }
+    inline void append(quint32 value) {
+        uchar data[4];
+        qToLittleEndian(value, data);
+        buffer.append((const char*)data, 4);
+    }
+    inline void append(float value) {
+        union { float f; quint32 i; } u;
+        u.f = value;
+        append(u.i);
+    }
+};
+
+#endif // INTERFACEHTTPPUSH_H
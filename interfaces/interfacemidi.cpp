@@ -26,6 +26,10 @@
 
 UiBool  InterfaceMidi::syncTransportIn  = true;
 UiBool  InterfaceMidi::syncTransportOut = true;
+UiBool  InterfaceMidi::syncClockOut     = false;
+UiBool  InterfaceMidi::syncMtcOut       = false;
+UiReal  InterfaceMidi::bandwidth        = 3125;
+UiReal  InterfaceMidi::mtcFps           = 25;
 QString InterfaceMidi::portInName    = "from_iannix";
 QString InterfaceMidi::portOutName   = "to_iannix";
 
@@ -36,6 +40,14 @@ InterfaceMidi::InterfaceMidi(QWidget *parent) :
     ui(new Ui::InterfaceMidi) {
     ui->setupUi(this);
     ui->midiJack->setVisible(false);
+    bundle = false;
+    clockIndex = mtcIndex = 0;
+    slaveRunning = slaveChasing = slaveMtc = false;
+    slaveEvents = -1;
+    slaveBase = slaveEventScore = slaveLast = slaveLockLast = 0;
+    slaveT0 = slaveT1 = slaveE2 = slaveB = slaveC = 0;
+    slaveTimer.start();
+    connect(&schedulersTimer, SIGNAL(timeout()), SLOT(networkFlush()));
     connect(ui->examples, SIGNAL(released()), SLOT(openExamples()));
     connect(ui->download, SIGNAL(released()), SLOT(downloadMidiJack()));
 
@@ -72,6 +84,8 @@ InterfaceMidi::InterfaceMidi(QWidget *parent) :
     enable          .setAction(ui->enable,                       "interfaceMidiEnable");
     syncTransportIn .setAction(ui->syncTransportIn,              "interfaceMidiSyncTransportIn");
     syncTransportOut.setAction(ui->syncTransportOut,             "interfaceMidiSyncTransportOut");
+    syncClockOut    .setAction(ui->syncClockOut,                 "interfaceMidiSyncClockOut");
+    syncMtcOut      .setAction(ui->syncMtcOut,                   "interfaceMidiSyncMtcOut");
     syncBpm         .setAction(ui->bpm,                          "interfaceMidiSyncBpm");
     MessageManager::aliases["midi_out"].setAction(ui->aliasPort, "interfaceMidiPortAlias");
 
@@ -102,7 +116,7 @@ void InterfaceMidi::timerEvent(QTimerEvent*) {
                 portIn.insert(getPortName(portName), new RtMidiIn());
                 portIn.value(getPortName(portName))->openPort(portListInIndex);
                 portIn.value(getPortName(portName))->setCallback(&midiCallback, this);
-                portIn.value(getPortName(portName))->ignoreTypes(true, true, true);
+                portIn.value(getPortName(portName))->ignoreTypes(true, false, true);
             }
         }
         catch(RtError &err) {}
@@ -134,122 +148,168 @@ void InterfaceMidi::timerEvent(QTimerEvent*) {
 #endif
 }
 
-bool InterfaceMidi::send(const Message &_message, QStringList *messageSent) {
+bool InterfaceMidi::send(const Message &message, QStringList *messageSent) {
     if(!enable)
         return false;
 
-    Message message  = _message;
     quint8 channel   = qBound(1, (int)message.getMidiValue(0), 16);
-    QString portname = message.getMidiPort();
-    QString command  = message.getMidiCommand().toLower();
+    const QString &portname = message.getMidiPort();
+    const QString &command  = message.getMidiCommand();
+    qreal value1 = message.getMidiValue(1), value2 = message.getMidiValue(2), value3 = message.getMidiValue(3);
+    bool isNote = false;
 
     //Send request
     if(command == "/notef") {
-        message.setMidiValue(1, qBound(0, (int)(message.getMidiValue(1)*127.), 127));
-        message.setMidiValue(2, qBound(0, (int)(message.getMidiValue(2)*127.), 127));
+        value1 = qBound(0, (int)(value1*127.), 127);
+        value2 = qBound(0, (int)(value2*127.), 127);
     }
     else if(command == "/ccf")
-        message.setMidiValue(2, qBound(0, (int)(message.getMidiValue(2)*127.), 127));
+        value2 = qBound(0, (int)(value2*127.), 127);
     else if(command == "/pgmf")
-        message.setMidiValue(1, message.getMidiValue(1)*127.);
+        value1 = value1*127.;
     else if(command == "/bendf")
-        message.setMidiValue(1, message.getMidiValue(1)*127.);
+        value1 = value1*127.;
 
 
     if((command == "/note") || (command == "/notef")) {
-        message.setMidiValue(1, message.getMidiValue(1), getNoteName(message.getMidiValue(1)));
-        message.setMidiValue(3, message.getMidiValue(3), QString("%1 s.").arg(message.getMidiValue(3)));
-        sendNote(portname, channel, message.getMidiValue(1), message.getMidiValue(2));
-        qreal duration = message.getMidiValue(3) * 1000.;
+        isNote = true;
+        sendNote(portname, channel, value1, value2);
+        qreal duration = value3 * 1000.;
         if(duration > 0)
-            new ExtMidiNoteOff(this, portname, channel, message.getMidiValue(1), duration);
+            new ExtMidiNoteOff(this, portname, channel, value1, duration);
     }
     else if((command == "/cc") || (command == "/ccf"))
-        sendCC  (portname, channel, message.getMidiValue(1), message.getMidiValue(2));
+        sendCC  (portname, channel, value1, value2);
     else if((command == "/pgm") || (command == "/pgmf"))
-        sendPGM (portname, channel, message.getMidiValue(1));
+        sendPGM (portname, channel, value1);
     else if((command == "/bend") || (command == "/bendf"))
-        sendBend(portname, channel, message.getMidiValue(1));
-
-    //Log in console
-    MessageManager::logSend(message, messageSent);
+        sendBend(portname, channel, value1);
+
+    //Log in console (only decorated if someone reads it)
+    if((messageSent) || (MessageManager::isLogging())) {
+        Message messageLog = message;
+        if(isNote) {
+            messageLog.setMidiValue(1, value1, getNoteName(value1));
+            messageLog.setMidiValue(2, value2);
+            messageLog.setMidiValue(3, value3, QString("%1 s.").arg(value3));
+        }
+        else if(command.endsWith("f")) {
+            messageLog.setMidiValue(1, value1);
+            messageLog.setMidiValue(2, value2);
+        }
+        MessageManager::logSend(messageLog, messageSent);
+    }
 
     return true;
 }
 
 void InterfaceMidi::sendNote(const QString & portname, quint8 channel, qreal _note, qreal _velocity) {
-    std::vector<unsigned char> message;
-    quint16 note     = qBound(0, (int)_note,     127);
-    quint16 velocity = qBound(0, (int)_velocity, 127);
-
-    note = (note > 0x7f) ? 0x7f : note;
-    velocity = (velocity > 0x7f) ? 0x7f : velocity;
-
-    if(velocity > 0)
-        message.push_back(STATUS_NOTEON + ((channel-1) & MASK_CHANNEL));
-    else
-        message.push_back(STATUS_NOTEOFF + ((channel-1) & MASK_CHANNEL));
-
-    message.push_back(note & MASK_SAFETY);
-    message.push_back(velocity & MASK_SAFETY);
-
-    if((message.size() > 0) && (portOut.contains(portname))) {
-        try {
-            portOut.value(portname)->sendMessage(&message);
-        } catch (RtError& err) { }
-    }
+    quint8 note     = qBound(0, (int)_note,     127);
+    quint8 velocity = qBound(0, (int)_velocity, 127);
+    quint8 status   = ((velocity > 0) ? STATUS_NOTEON : STATUS_NOTEOFF) + ((channel-1) & MASK_CHANNEL);
+    queue(portname, status | ((note & MASK_SAFETY) << 8) | ((velocity & MASK_SAFETY) << 16) | (3 << 24));
 }
 void InterfaceMidi::sendCC(const QString & portname, quint8 channel, quint16 controller, qreal _value) {
-    std::vector<unsigned char> message;
-    quint16 value = qBound(0, (int)_value, 127);
-
-    controller = (controller > 0x7f) ? 0x7f : controller;
-    value      = (value > 0x7f) ? 0x7f : value;
+    quint8 value = qBound(0, (int)_value, 127);
+    controller   = (controller > 0x7f) ? 0x7f : controller;
 
     // Controller: 0xB0 + channel, ctl, val
-    message.push_back(STATUS_CTLCHG + ((channel-1) & MASK_CHANNEL));
-    message.push_back(controller & MASK_SAFETY);
-    message.push_back(value & MASK_SAFETY);
-
-    if((message.size() > 0) && (portOut.contains(portname))) {
-        try {
-            portOut.value(portname)->sendMessage(&message);
-        } catch (RtError& err) { }
-    }
+    queue(portname, (STATUS_CTLCHG + ((channel-1) & MASK_CHANNEL)) | ((controller & MASK_SAFETY) << 8) | ((value & MASK_SAFETY) << 16) | (3 << 24));
 }
 void InterfaceMidi::sendPGM(const QString & portname, quint8 channel, quint16 program) {
-    std::vector<unsigned char> message;
     program = (program > 0x7f) ? 0x7f : program;
 
     // Program: 0xC0 + channel, pgm
-    message.push_back(STATUS_PROGRAM + ((channel-1) & MASK_CHANNEL));
-    message.push_back(program & MASK_SAFETY);
-
-    if((message.size() > 0) && (portOut.contains(portname))) {
-        try {
-            portOut.value(portname)->sendMessage(&message);
-        } catch (RtError& err) {  }
-    }
+    queue(portname, (STATUS_PROGRAM + ((channel-1) & MASK_CHANNEL)) | ((program & MASK_SAFETY) << 8) | (2 << 24));
 }
 void InterfaceMidi::sendBend(const QString & portname, quint8 channel, qreal _bendvalue) {
-    std::vector<unsigned char> message;
     quint16 bendvalue = _bendvalue;
     bendvalue = (bendvalue > 0x3fff) ? 0x3fff : bendvalue;
 
     // Bend: 0xE0 + channel, 7LeastSigBits, 7MostSigBits
     quint8 lsb = 0x7f & bendvalue;
     quint8 msb = 0x7f & (bendvalue >> 7);
+    queue(portname, (STATUS_BEND + ((channel-1) & MASK_CHANNEL)) | (lsb << 8) | (msb << 16) | (3 << 24));
+}
 
-    message.push_back(STATUS_BEND + ((channel-1) & MASK_CHANNEL));
-    message.push_back(lsb & MASK_SAFETY);
-    message.push_back(msb & MASK_SAFETY);
+void InterfaceMidi::queue(const QString & portname, quint32 packed) {
+    if(!portOut.contains(portname))
+        return;
+    InterfaceMidiScheduler *scheduler = schedulers.value(portname);
+    if(!scheduler) {
+        scheduler = new InterfaceMidiScheduler();
+        schedulers.insert(portname, scheduler);
+    }
+    scheduler->push(packed);
 
-    if((message.size() > 0) && (portOut.contains(portname))) {
-        try {
-            portOut.value(portname)->sendMessage(&message);
-        } catch (RtError& err) { }
+    //Outside of a scheduler tick (note off, manual sends), go out immediately
+    if(!bundle)
+        networkFlush();
+}
+void InterfaceMidi::networkBundle(bool start) {
+    bundle = start;
+    if(!start) {
+        if(enable)
+            sendClock();
+        networkFlush();
+    }
+}
+void InterfaceMidi::networkFlush() {
+    bool pending = false;
+    QHashIterator<QString, InterfaceMidiScheduler*> schedulerIterator(schedulers);
+    while(schedulerIterator.hasNext()) {
+        schedulerIterator.next();
+        RtMidiOut *port = portOut.value(schedulerIterator.key());
+        if(port)
+            schedulerIterator.value()->flush(port, bandwidth);
+        pending |= !schedulerIterator.value()->isEmpty();
+    }
+
+    //Controllers left over by the bandwidth budget are drained between ticks
+    if((pending) && (!schedulersTimer.isActive()))
+        schedulersTimer.start(5);
+    else if((!pending) && (schedulersTimer.isActive()))
+        schedulersTimer.stop();
+}
+
+void InterfaceMidiScheduler::push(quint32 packed) {
+    quint8 type = packed & MASK_STATUS;
+    if((type == STATUS_BEND) || ((type == STATUS_CTLCHG) && (!isSetupController((packed >> 8) & 0xFF)))) {
+        //Continuous values: only the latest value of a controller survives the tick
+        quint16 key = (packed & 0xFF) | ((type == STATUS_CTLCHG) ? (packed & 0xFF00) : 0);
+        if(!continuous.contains(key))
+            continuousOrder.append(key);
+        continuous.insert(key, packed);
     }
+    else
+        //Notes, program changes and setup controllers keep their order (bank select before program change…)
+        priority.append(packed);
+}
+void InterfaceMidiScheduler::flush(RtMidiOut *port, qreal budget) {
+    //Token bucket refilled with the elapsed time, small bursts allowed
+    if(budget > 0)
+        credit = qMin(credit + budget * elapsed.restart() / 1000., qMax(budget * MIDI_BURST, 3.));
+
+    //Notes, program changes and setup controllers first, whatever the budget
+    while(!priority.isEmpty())
+        write(port, priority.takeFirst());
+
+    //Controllers while there is bandwidth left
+    while((!continuousOrder.isEmpty()) && ((budget <= 0) || (credit >= (continuous.value(continuousOrder.first()) >> 24))))
+        write(port, continuous.take(continuousOrder.takeFirst()));
+}
+void InterfaceMidiScheduler::write(RtMidiOut *port, quint32 packed) {
+    quint8 size = packed >> 24;
+    message.resize(size);
+    for(quint8 index = 0 ; index < size ; index++)
+        message[index] = (packed >> (8*index)) & 0xFF;
+
+    credit -= size;
+    try {
+        port->sendMessage(&message);
+    } catch (RtError& err) { }
 }
+
 void InterfaceMidi::networkSynchro(bool start) {
     if(syncTransportOut) {
         if(start) {
@@ -259,31 +319,32 @@ void InterfaceMidi::networkSynchro(bool start) {
         else
             sendSPPStop();
     }
+    if(start) {
+        //Clocks and quarter frames restart from the current position
+        clockIndex = qFloor(Transport::timeLocal / ((60. / qMax((qreal)1, (qreal)syncBpm)) / MIDI_CLOCK_PPQN));
+        mtcIndex   = qFloor(Transport::timeLocal * getMtcFps() / 2.) * 8;
+        if(syncMtcOut)
+            sendMTCTime(Transport::timeLocal);
+    }
 }
 
+void InterfaceMidi::sendAll(std::vector<unsigned char> &message) {
+    foreach(RtMidiOut *port, portOut) {
+        try {
+            port->sendMessage(&message);
+        } catch (RtError& err) {
+        }
+    }
+}
 void InterfaceMidi::sendSPPStart() {
     std::vector<unsigned char> message;
     message.push_back(MIDI_CONTINUE);
-    if(message.size() > 0) {
-        foreach(RtMidiOut *port, portOut) {
-            try {
-                port->sendMessage(&message);
-            } catch (RtError& err) {
-            }
-        }
-    }
+    sendAll(message);
 }
 void InterfaceMidi::sendSPPStop() {
     std::vector<unsigned char> message;
     message.push_back(MIDI_STOP);
-    if(message.size() > 0) {
-        foreach(RtMidiOut *port, portOut) {
-            try {
-                port->sendMessage(&message);
-            } catch (RtError& err) {
-            }
-        }
-    }
+    sendAll(message);
 }
 void InterfaceMidi::sendSPPTime(qreal time) {
     quint16 slaveTime = (time / ((60. / syncBpm) / 16.)) / 4.;
@@ -293,11 +354,57 @@ void InterfaceMidi::sendSPPTime(qreal time) {
     message.push_back(MIDI_SPP);
     message.push_back(val1);
     message.push_back(val2);
-    if(message.size() > 0) {
-        foreach(RtMidiOut *port, portOut) {
-            try {
-                port->sendMessage(&message);
-            } catch (RtError& err) {
+    sendAll(message);
+}
+void InterfaceMidi::sendMTCTime(qreal time) {
+    //Full frame: F0 7F 7F 01 01 hh mm ss ff F7
+    qreal   fps    = getMtcFps();
+    quint32 frames = qRound(fps);
+    quint32 frame  = time * fps;
+    quint8  rate   = (fps < 24.5) ? (0) : ((fps < 27) ? (1) : (3));
+
+    std::vector<unsigned char> message;
+    message.push_back(0xF0);
+    message.push_back(0x7F);
+    message.push_back(0x7F);
+    message.push_back(0x01);
+    message.push_back(0x01);
+    message.push_back(((rate & 0x03) << 5) | ((frame / (frames*3600)) % 24));
+    message.push_back((frame / (frames*60)) % 60);
+    message.push_back((frame / frames) % 60);
+    message.push_back(frame % frames);
+    message.push_back(0xF7);
+    sendAll(message);
+}
+void InterfaceMidi::sendClock() {
+    //Clocks and quarter frames due since the last tick, locked on the score time
+    if((syncClockOut) && (syncBpm > 0)) {
+        qint64 target = qFloor(Transport::timeLocal / ((60. / syncBpm) / MIDI_CLOCK_PPQN));
+        if(qAbs(target - clockIndex) > MIDI_CLOCK_BURST) {
+            //Relocation
+            clockIndex = target;
+            sendSPPTime(Transport::timeLocal);
+        }
+        std::vector<unsigned char> message(1, MIDI_CLOCK);
+        while(clockIndex < target) {
+            sendAll(message);
+            clockIndex++;
+        }
+    }
+    if(syncMtcOut) {
+        qreal fps = getMtcFps();
+        qint64 target = qFloor(Transport::timeLocal * fps * 4);
+        if(qAbs(target - mtcIndex) > MIDI_CLOCK_BURST) {
+            //Relocation, quarter frames restart on an even frame
+            mtcIndex = (target / 8) * 8;
+            sendMTCTime(Transport::timeLocal);
+        }
+        if(mtcIndex < target) {
+            std::vector<unsigned char> message(2, MIDI_TIMECODE);
+            while(mtcIndex < target) {
+                message[1] = ExtMidiMTC::encode(mtcIndex, fps);
+                sendAll(message);
+                mtcIndex++;
             }
         }
     }
@@ -313,6 +420,7 @@ void InterfaceMidi::receivedMessage(const QString & destination, const QStringLi
 }
 void InterfaceMidi::networkManualParsing() {
     mutex.lock();
+    slaveLock();
     while(receivedMessages.count()) {
         //Fire events (log, message and script mapping)
         QString command = receivedMessages.first().first;
@@ -339,76 +447,161 @@ void InterfaceMidi::receivedMidiRealtime(quint8 type, quint8 val1, quint8 val2)
         mutex.lock();
         if(type == MIDI_SPP) {
             qreal time = (128*val2 + val1) * 4 * ((60. / syncBpm) / 16);
+            slaveBase   = time;
+            slaveEvents = -1;
             if(time == 0)   receivedCommands << COMMAND_FF;
             else            receivedCommands << QString("%1 %2").arg(COMMAND_GOTO).arg(time);
         }
-        else if((type == MIDI_CLOCK) || (type == MIDI_TICK) || (type == MIDI_TIMECODE)) {
-            //qreal delta = (60. / syncBpm) / 24.;
-            //qreal slaveTime = midiMtc.decode(val1);
-            //qDebug("TIMECODE %f", slaveTime);
+        else if(type == MIDI_CLOCK) {
+            slaveMtc = false;
+            slaveEvent((60. / syncBpm) / MIDI_CLOCK_PPQN);
         }
-        else if(type == MIDI_CONTINUE)
+        else if(type == MIDI_TIMECODE) {
+            qreal time = 0;
+            slaveMtc = true;
+            slaveEvent(1. / (4. * midiMtc.fps));
+            if(midiMtc.decode(val1, &time)) {
+                //Only a real jump relocates, the loop takes care of the rest
+                if((!slaveChasing) || (qAbs(slaveBase + slaveEvents * slaveEventScore - time) > 1. / midiMtc.fps)) {
+                    slaveBase   = time;
+                    slaveEvents = 0;
+                }
+                slaveChasing = true;
+            }
+        }
+        else if(type == MIDI_CONTINUE) {
+            slaveChasing = true;
             receivedCommands << COMMAND_PLAY;
-        else if(type == MIDI_STOP)
+        }
+        else if(type == MIDI_STOP) {
+            //Resume point for a later continue
+            if(slaveEvents >= 0)
+                slaveBase += slaveEvents * slaveEventScore;
+            slaveEvents  = -1;
+            slaveChasing = false;
             receivedCommands << COMMAND_STOP;
-        else if(type == MIDI_START)
+        }
+        else if(type == MIDI_START) {
+            slaveBase    = 0;
+            slaveEvents  = -1;
+            slaveChasing = true;
             receivedCommands << COMMAND_PLAY;
+        }
         mutex.unlock();
     }
 }
+void InterfaceMidi::slaveEvent(qreal eventScore) {
+    qreal now = slaveTimer.nsecsElapsed() / 1000000000.;
+    if((!slaveRunning) || (eventScore != slaveEventScore) || (now - slaveLast > MIDI_SLAVE_TIMEOUT)) {
+        //Second-order DLL (re)started on the nominal period
+        qreal omega = 2 * M_PI * MIDI_SLAVE_BANDWIDTH * eventScore;
+        slaveB  = qSqrt(2.) * omega;
+        slaveC  = omega * omega;
+        slaveE2 = eventScore;
+        slaveT0 = now;
+        slaveT1 = now + slaveE2;
+        slaveEventScore = eventScore;
+        slaveRunning    = true;
+    }
+    else {
+        //Filtered time of this event and period estimate
+        qreal error = now - slaveT1;
+        slaveT0  = slaveT1;
+        slaveT1 += slaveB * error + slaveE2;
+        slaveE2 += slaveC * error;
+    }
+    if(slaveChasing)
+        slaveEvents++;
+    slaveLast = now;
+}
+void InterfaceMidi::slaveLock() {
+    qreal speed = 1;
+    qreal now   = slaveTimer.nsecsElapsed() / 1000000000.;
+    qreal last  = (slaveLockLast > 0) ? (slaveLockLast) : (now);
+    slaveLockLast = now;
+
+    //Master went silent
+    if((slaveChasing) && (now - slaveLast > MIDI_SLAVE_TIMEOUT)) {
+        slaveChasing = false;
+        slaveRunning = false;
+        if(slaveMtc)
+            receivedCommands << COMMAND_STOP;
+    }
 
+    if((syncTransportIn) && (slaveChasing) && (slaveRunning) && (slaveEvents >= 0) && (slaveE2 > 0)) {
+        if(!Transport::timerOk) {
+            //Time code has no start message: chase it
+            if(slaveMtc)
+                receivedCommands << QString("%1 %2").arg(COMMAND_GOTO).arg(slaveBase + (slaveEvents + (now - slaveT0) / slaveE2) * slaveEventScore) << COMMAND_PLAY;
+        }
+        else {
+            //Score time still holds the previous tick, compare it with the master at that moment
+            qreal target = slaveBase + (slaveEvents + (last - slaveT0) / slaveE2) * slaveEventScore;
+            qreal error  = target - Transport::timeLocal;
+            if(qAbs(error) > MIDI_SLAVE_RELOCATE)
+                receivedCommands << QString("%1 %2").arg(COMMAND_GOTO).arg(target);
+            else if(Transport::scoreSpeed > 0)
+                speed = qBound(0.5, (slaveEventScore / slaveE2 + error / MIDI_SLAVE_SETTLE) / Transport::scoreSpeed, 2.);
+        }
+    }
+    Transport::syncSpeed = speed;
+}
 
 
 
 
-qreal ExtMidiMTC::decode(quint16 msg) {
-    int times[4]   = {0, 0, 0, 0};
-    QString szType = "";
-    int numFrames  = 100;
-    qreal smpteTime = 0;
-
-    int messageIndex        = msg >> 4;
-    int value               = msg & 0x0F;
-    int timeIndex           = messageIndex>>1;
-    bool bNewFrame          = messageIndex % 4 == 0;
-
-    if(bNewFrame) {
-        times[kMTCFrames]++;
-        if(times[kMTCFrames] >= numFrames) {
-            times[kMTCFrames] %= numFrames;
-            times[kMTCSeconds]++;
-            if(times[kMTCSeconds] >= 60) {
-                times[kMTCSeconds] %= 60;
-                times[kMTCMinutes]++;
-                if(times[kMTCMinutes] >= 60) {
-                    times[kMTCMinutes] %= 60;
-                    times[kMTCHours]++;
-                }
-            }
-        }
-        Q_ASSERT_X(numFrames > 0, "MTCDecoder", "Error in received MIDI Time Code");
-        smpteTime = (qreal)(3600*times[kMTCHours] + 60*times[kMTCMinutes] + times[kMTCSeconds] + times[kMTCFrames]) / (qreal)numFrames;
-    }
 
+bool ExtMidiMTC::decode(quint8 data, qreal *time) {
+    quint8 piece = (data >> 4) & 0x07;
+    if(piece == 0)
+        received = 0;
+    pieces[piece] = data & 0x0F;
+    received |= 1 << piece;
+    if((piece != 7) || (received != 0xFF))
+        return false;
 
-    if(messageIndex % 2 == 0)   times[timeIndex]  = value;
-    else                        times[timeIndex] |= value<<4;
+    fps = getFps((pieces[7] >> 1) & 0x03);
+    quint8 frames  = pieces[0] | (pieces[1] << 4);
+    quint8 seconds = pieces[2] | (pieces[3] << 4);
+    quint8 minutes = pieces[4] | (pieces[5] << 4);
+    quint8 hours   = pieces[6] | ((pieces[7] & 0x01) << 4);
 
-    if(messageIndex == 7) {
-        times[kMTCHours] &= 0x1F;
-        int smpteType = value >> 1;
-        switch(smpteType) {
-        case 0: numFrames = 24; szType = "24 fps"; break;
-        case 1: numFrames = 25; szType = "25 fps"; break;
-        case 2: numFrames = 30; szType = "30 fps (drop-frame)"; break;
-        case 3: numFrames = 30; szType = "30 fps"; break;
-        default: numFrames = 100; szType = " **** unknown SMPTE type ****";
-        }
+    //The eight quarter frames took two frames to arrive
+    *time = hours * 3600. + minutes * 60. + seconds + (frames + 2) / fps;
+    return true;
+}
+quint8 ExtMidiMTC::encode(quint32 quarterFrame, qreal fps) {
+    quint8  rate   = (fps < 24.5) ? (0) : ((fps < 27) ? (1) : (3));
+    quint32 frames = qRound(fps);
+    quint32 frame  = (quarterFrame / 8) * 2;
+    quint8  piece  = quarterFrame % 8;
+    quint8  ff = frame % frames, ss = (frame / frames) % 60, mm = (frame / (frames*60)) % 60, hh = (frame / (frames*3600)) % 24;
+    quint8  nibble = 0;
+    switch(piece) {
+    case 0: nibble = ff & 0x0F; break;
+    case 1: nibble = ff >> 4;   break;
+    case 2: nibble = ss & 0x0F; break;
+    case 3: nibble = ss >> 4;   break;
+    case 4: nibble = mm & 0x0F; break;
+    case 5: nibble = mm >> 4;   break;
+    case 6: nibble = hh & 0x0F; break;
+    case 7: nibble = ((hh >> 4) & 0x01) | (rate << 1); break;
+    }
+    return (piece << 4) | nibble;
+}
+qreal ExtMidiMTC::getFps(quint8 rate) {
+    switch(rate) {
+    case 0:  return 24;
+    case 1:  return 25;
+    case 2:  return 29.97;
+    default: return 30;
     }
-    return smpteTime;
 }
 
 void InterfaceMidi::clear() {
+    schedulersTimer.stop();
+    qDeleteAll(schedulers);
+    schedulers.clear();
     foreach(RtMidiIn  *port, portIn) {
         port->closePort();
         delete port;
@@ -26,6 +26,9 @@
 
 #include <QWidget>
 #include <QMutex>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QtCore/qmath.h>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
@@ -54,10 +57,14 @@
 #define MIDI_SPP          0xF2
 #define MIDI_TIMECODE     0xF1
 
-#define kMTCFrames      0
-#define kMTCSeconds     1
-#define kMTCMinutes     2
-#define kMTCHours       3
+#define MIDI_BURST        0.02
+
+#define MIDI_CLOCK_PPQN         24
+#define MIDI_CLOCK_BURST        48
+#define MIDI_SLAVE_BANDWIDTH    0.5
+#define MIDI_SLAVE_TIMEOUT      0.25
+#define MIDI_SLAVE_SETTLE       0.5
+#define MIDI_SLAVE_RELOCATE     0.25
 
 void midiCallback(double deltatime, std::vector< unsigned char > *receivedMessage, void *userData);
 
@@ -65,11 +72,49 @@ void midiCallback(double deltatime, std::vector< unsigned char > *receivedMessag
 class ExtMidiMTC : public QObject {
     Q_OBJECT
 public:
-    qreal decode(quint16);
+    ExtMidiMTC() {
+        received = 0;
+        fps      = 25;
+        for(quint8 piece = 0 ; piece < 8 ; piece++)
+            pieces[piece] = 0;
+    }
+public:
+    bool   decode(quint8 data, qreal *time);
+    static quint8 encode(quint32 quarterFrame, qreal fps);
+    static qreal  getFps(quint8 rate);
 
+public:
+    qreal  fps;
 private:
-    int     port, channel, status, byteOne, byteTwo;
-    double  timestamp;
+    quint8 pieces[8];
+    quint8 received;
+};
+
+//Messages are packed as status | data1 << 8 | data2 << 16 | size << 24
+class InterfaceMidiScheduler {
+public:
+    InterfaceMidiScheduler() {
+        credit = 0;
+        elapsed.start();
+    }
+
+public:
+    QList<quint32> priority;
+    QHash<quint16, quint32> continuous;
+    QList<quint16> continuousOrder;
+    qreal credit;
+    QElapsedTimer elapsed;
+    std::vector<unsigned char> message;
+public:
+    inline bool isEmpty() const { return (priority.isEmpty()) && (continuousOrder.isEmpty()); }
+    void push(quint32 packed);
+    void flush(RtMidiOut *port, qreal budget);
+private:
+    void write(RtMidiOut *port, quint32 packed);
+    static inline bool isSetupController(quint8 controller) {
+        //Bank select, data entry and (N)RPN: sequences that must not be merged or deferred
+        return (controller == 0) || (controller == 32) || (controller == 6) || (controller == 38) || ((controller >= 98) && (controller <= 101));
+    }
 };
 
 namespace Ui {
@@ -86,6 +131,8 @@ public:
 
 public:
     static UiBool syncTransportIn, syncTransportOut;
+    static UiBool syncClockOut, syncMtcOut;
+    static UiReal bandwidth, mtcFps;
     static QString midiNotes[12];
     static QString getNoteName(quint16 noteValue);
 private:
@@ -96,6 +143,9 @@ private:
 private:
     QHash<QString, RtMidiIn*> portIn;
     QHash<QString, RtMidiOut*> portOut;
+    QHash<QString, InterfaceMidiScheduler*> schedulers;
+    QTimer schedulersTimer;
+    bool bundle;
     QList<QPair<QString, QStringList> > receivedMessages;
     QStringList receivedCommands;
     QMutex mutex;
@@ -115,6 +165,20 @@ private:
 
 public:
     ExtMidiMTC midiMtc;
+private:
+    //Master: clocks and quarter frames already sent
+    qint64 clockIndex, mtcIndex;
+    //Slave: delay-locked loop on incoming clock or quarter frames
+    QElapsedTimer slaveTimer;
+    bool   slaveRunning, slaveChasing, slaveMtc;
+    qint64 slaveEvents;
+    qreal  slaveBase, slaveEventScore, slaveLast, slaveLockLast;
+    qreal  slaveT0, slaveT1, slaveE2, slaveB, slaveC;
+    void slaveEvent(qreal eventScore);
+    void slaveLock();
+    inline qreal getMtcFps() const {
+        return (mtcFps < 24.5) ? (24) : ((mtcFps < 27) ? (25) : (30));
+    }
 
 protected:
     void timerEvent(QTimerEvent *);
@@ -126,7 +190,9 @@ public:
     void sendPGM (const QString & portname, quint8 channel, quint16 program);
     void sendBend(const QString & portname, quint8 channel, qreal   bendvalue);
     void networkSynchro(bool start);
+    void networkBundle(bool start);
 private:
+    void queue(const QString & portname, quint32 packed);
     void sendSPPStart();
     void sendSPPStop();
     void sendSPPTime(qreal time);
@@ -135,6 +201,7 @@ public slots:
     void receivedMessage(const QString & destination, const QStringList &arguments);
     void receivedMidiRealtime(quint8 type, quint8 val1, quint8 val2);
     void networkManualParsing();
+    void networkFlush();
     void openExamples() {
         QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(Application::pathPatches.absoluteFilePath() + "/Ableton Live/").absoluteFilePath()));
     }
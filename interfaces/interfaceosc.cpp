@@ -30,6 +30,7 @@ InterfaceOsc::InterfaceOsc(QWidget *parent) :
     ui->setupUi(this);
     //connect(ui->examples, SIGNAL(released()), SLOT(openExamples()));
     socket = 0;
+    sender = new MessageSender("OSC", this);
 
     bonjourMenu = new QMenu(this);
     connect(ui->bonjour,       SIGNAL(released()), SLOT(openBonjour()));
@@ -50,6 +51,8 @@ InterfaceOsc::InterfaceOsc(QWidget *parent) :
 
     bundlePort = 0;
     bundleMessageId = 0;
+    bundleMessagesCount = 0;
+    bundleBuffer.reserve(4096);
 
     //Interfaces link
     enable.setAction(ui->enable,         "interfaceOscEnable");
@@ -74,7 +77,8 @@ void InterfaceOsc::portChanged() {
     socket = new QUdpSocket(this);
     //connect(socket, SIGNAL(readyRead()), SLOT(parseOSC()));
 
-    if(socket->bind(port))  ui->port->setStyleSheet(ihmFeedbackOk);
+    sender->setPort(port);
+    if(socket->bind(port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))  ui->port->setStyleSheet(ihmFeedbackOk);
     else                    ui->port->setStyleSheet(ihmFeedbackNok);
 
     UiHelp::oscPort = port;
@@ -409,13 +413,23 @@ bool InterfaceOsc::send(const Message &message, QStringList *messageSent) {
     if(!enable)
         return false;
 
-    if((message.getPort() == bundlePort) && (message.getHost() == QHostAddress(bundleHost))) {
-        //Add message to bundle
-        bundleMessages.append(message);
+    if((message.getPort() == bundlePort) && (message.getHost() == bundleHostAddress)) {
+        //Add message to bundle (size + content)
+        union { int i; char ch[4]; } u;
+        u.i = message.getBuffer().count();
+        bundleBuffer += u.ch[3];
+        bundleBuffer += u.ch[2];
+        bundleBuffer += u.ch[1];
+        bundleBuffer += u.ch[0];
+        bundleBuffer += message.getBuffer();
+        bundleMessagesCount++;
+
+        //Log in console
+        MessageManager::logSend(message, messageSent);
     }
     else {
-        //Write a message on the opened socket
-        socket->writeDatagram(message.getBuffer(), message.getHost(), message.getPort());
+        //Queue the message for the sender thread
+        sender->push(message.getBuffer(), message.getHost(), message.getPort());
 
         //Log in console
         MessageManager::logSend(message, messageSent);
@@ -423,40 +437,26 @@ bool InterfaceOsc::send(const Message &message, QStringList *messageSent) {
     return true;
 }
 void InterfaceOsc::networkBundle(bool start) {
-    if(start)
-        bundleMessages.clear();
-    else if((bundlePort) && (bundleMessages.count()) && (!QHostAddress(bundleHost).isNull())) {
-        QByteArray messageBuffer;
-        //Bundle
-        messageBuffer += "#bundle";
-        messageBuffer += (char)0;
+    if(start) {
+        bundleBuffer.resize(0);
+        bundleMessagesCount = 0;
+        bundleHostAddress = QHostAddress(bundleHost);
+
+        //Bundle header, timecode is filled when the bundle is sent
+        bundleBuffer += "#bundle";
+        bundleBuffer += (char)0;
+        for(quint8 i = 0 ; i < 8 ; i++)
+            bundleBuffer += (char)0;
+    }
+    else if((bundlePort) && (bundleMessagesCount) && (!bundleHostAddress.isNull())) {
         //Timecode
-        union { int i; char ch[8]; } u;
+        union { qint64 i; char ch[8]; } u;
         u.i = bundleMessageId++;
-        messageBuffer += u.ch[7];
-        messageBuffer += u.ch[6];
-        messageBuffer += u.ch[5];
-        messageBuffer += u.ch[4];
-        messageBuffer += u.ch[3];
-        messageBuffer += u.ch[2];
-        messageBuffer += u.ch[1];
-        messageBuffer += u.ch[0];
-
-        foreach(const Message &bundleMessage, bundleMessages) {
-            //Size of message
-            union { int i; char ch[4]; } u;
-            u.i = bundleMessage.getBuffer().count();
-            messageBuffer += u.ch[3];
-            messageBuffer += u.ch[2];
-            messageBuffer += u.ch[1];
-            messageBuffer += u.ch[0];
-            //Message content
-            messageBuffer += bundleMessage.getBuffer();
-            //Log in console
-            MessageManager::logSend(bundleMessage);
-        }
-        bundleMessages.clear();
-        socket->writeDatagram(messageBuffer, QHostAddress(bundleHost), bundlePort);
+        for(quint8 i = 0 ; i < 8 ; i++)
+            bundleBuffer[8 + i] = u.ch[7 - i];
+
+        sender->push(bundleBuffer, bundleHostAddress, bundlePort);
+        bundleMessagesCount = 0;
     }
 }
 
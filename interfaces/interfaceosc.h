@@ -78,6 +78,7 @@ public:
 private:
     UiReal port, bundlePort;
     UiString bundleHost;
+    QHostAddress bundleHostAddress;
     UiBool enable;
 
 private:
@@ -113,8 +114,10 @@ private slots:
 
 private:
     QUdpSocket *socket;
+    MessageSender *sender;
     QString oscMatchAdressIanniX, oscMatchAdressTransport;
-    QList<Message> bundleMessages;
+    QByteArray bundleBuffer;
+    quint16 bundleMessagesCount;
     quint64 bundleMessageId;
 private:
     quint8 bufferI[4096*4], bufferO[4096*4];
@@ -29,6 +29,7 @@ InterfaceSerial::InterfaceSerial(QWidget *parent) :
     ui(new Ui::InterfaceSerial) {
     ui->setupUi(this);
     port = 0;
+    ringRead = ringScan = ringWrite = 0;
     connect(ui->examples, SIGNAL(released()), SLOT(openExamples()));
 
     baudrateEnum << BAUD110;
@@ -42,6 +43,12 @@ InterfaceSerial::InterfaceSerial(QWidget *parent) :
     baudrateEnum << BAUD38400;
     baudrateEnum << BAUD57600;
     baudrateEnum << BAUD115200;
+    baudrateEnum << (BaudRateType)230400;
+    baudrateEnum << (BaudRateType)460800;
+    baudrateEnum << (BaudRateType)500000;
+    baudrateEnum << (BaudRateType)921600;
+    baudrateEnum << (BaudRateType)1000000;
+    baudrateEnum << (BaudRateType)2000000;
 
     databitsEnum << DATA_5;
     databitsEnum << DATA_6;
@@ -69,18 +76,21 @@ InterfaceSerial::InterfaceSerial(QWidget *parent) :
     portParity.setAction(ui->parityCombo, "interfaceSerialParity");
     portStop  .setAction(ui->stopCombo,   "interfaceSerialStop");
     portFlow  .setAction(ui->flowCombo,   "interfaceSerialFlow");
+    portFormat.setAction(ui->formatCombo, "interfaceSerialFormat");
     connect(&portName,   SIGNAL(triggered(QString)), SLOT(portChanged()));
     connect(&portBaud,   SIGNAL(triggered(qreal)),   SLOT(portChanged()));
     connect(&portBits,   SIGNAL(triggered(qreal)),   SLOT(portChanged()));
     connect(&portParity, SIGNAL(triggered(qreal)),   SLOT(portChanged()));
     connect(&portStop,   SIGNAL(triggered(qreal)),   SLOT(portChanged()));
     connect(&portFlow,   SIGNAL(triggered(qreal)),   SLOT(portChanged()));
+    connect(&portFormat, SIGNAL(triggered(qreal)),   SLOT(formatChanged()));
 
     portBaud   = 10;
     portBits   = 3;
     portParity = 0;
     portStop   = 0;
     portFlow   = 0;
+    portFormat = 0;
 
     connect(ui->enable, SIGNAL(toggled(bool)), SLOT(portChanged()));
     //Valeurs par défaut
@@ -101,6 +111,7 @@ void InterfaceSerial::timerEvent(QTimerEvent *) {
 }
 
 void InterfaceSerial::portChanged() {
+    ringRead = ringScan = ringWrite;
     if(enable) {
         if(port) {
             port->close();
@@ -127,36 +138,120 @@ void InterfaceSerial::portChanged() {
     }
 }
 
+void InterfaceSerial::formatChanged() {
+    //Pending bytes belong to the previous format
+    ringRead = ringScan = ringWrite;
+}
+
 void InterfaceSerial::parse() {
-    QByteArray receptionTmp;
-    int a = port->bytesAvailable();
-    receptionTmp.resize(a);
-    port->read(receptionTmp.data(), receptionTmp.size());
+    //Read straight into the ring, complete lines are extracted after each chunk
+    qint64 available = port->bytesAvailable();
+    while(available > 0) {
+        quint32 free = INTERFACE_SERIAL_RING - (ringWrite - ringRead);
+        if(free == 0) {
+            //Only an unterminated line can fill the whole ring: drop it
+            qDebug("[Serial] Reception buffer overflow, %d bytes of a partial line dropped", INTERFACE_SERIAL_RING);
+            ringRead = ringScan = ringWrite;
+            free = INTERFACE_SERIAL_RING;
+        }
+        quint32 offset = ringWrite & INTERFACE_SERIAL_RING_MASK;
+        qint64 size = port->read(ring + offset, qMin((qint64)qMin(free, (quint32)INTERFACE_SERIAL_RING - offset), available));
+        if(size <= 0)
+            break;
+        ringWrite += size;
+        available -= size;
 
-    if(enable) {
-        reception.append(receptionTmp);
-        bool nextMessage = true;
-        while(nextMessage) {
-            nextMessage = false;
-            quint16 index = 0;
-            QString command;
-            while((index < reception.size()) && (!nextMessage)) {
-                if(reception.at(index) == COMMAND_END_BYTE) {
-                    reception = reception.remove(0, index);
-                    index = 0;
-                    command = command.remove('\n');
-                    command = command.remove('\r');
-
-                    if(command != "")
-                        MessageManager::incomingMessage(MessageIncomming("serial", portName, 0, "", command, command.split(" ", QString::SkipEmptyParts)));
-                    command = "";
-                }
-                else
-                    command += reception.at(index);
-                index++;
-            }
+        if(!enable)
+            ringRead = ringScan = ringWrite;
+        else if(portFormat.val() > 0)
+            parseFrames();
+        else
+            parseLines();
+    }
+}
+void InterfaceSerial::parseLines() {
+    //Scan only the bytes received since the last call
+    while(ringScan != ringWrite) {
+        quint32 offset = ringScan & INTERFACE_SERIAL_RING_MASK;
+        quint32 size   = qMin(ringWrite - ringScan, (quint32)INTERFACE_SERIAL_RING - offset);
+        const char *end = (const char*)memchr(ring + offset, COMMAND_END_BYTE, size);
+        if(!end) {
+            ringScan += size;
+            continue;
+        }
+        ringScan += end - (ring + offset);
+        parseLine(ringRead, ringScan);
+        ringScan++;
+        ringRead = ringScan;
+    }
+}
+void InterfaceSerial::parseLine(quint32 start, quint32 end) {
+    //Tokenize in place, lines wrapping around the ring are copied once
+    quint32 offset = start & INTERFACE_SERIAL_RING_MASK;
+    quint32 size   = end - start;
+    const char *data = ring + offset;
+    if(offset + size > INTERFACE_SERIAL_RING) {
+        quint32 sizeFirst = INTERFACE_SERIAL_RING - offset;
+        line.resize(size);
+        memcpy(line.data(), ring + offset, sizeFirst);
+        memcpy(line.data() + sizeFirst, ring, size - sizeFirst);
+        data = line.constData();
+    }
+
+    //Trim spaces and carriage returns
+    while((size > 0) && ((data[0] == ' ') || (data[0] == '\r'))) {
+        data++;
+        size--;
+    }
+    while((size > 0) && ((data[size-1] == ' ') || (data[size-1] == '\r')))
+        size--;
+    if(size == 0)
+        return;
+
+    QStringList arguments;
+    quint32 tokenStart = 0;
+    for(quint32 index = 0 ; index <= size ; index++) {
+        if((index == size) || (data[index] == ' ') || (data[index] == '\r')) {
+            if(index > tokenStart)
+                arguments << QString::fromLatin1(data + tokenStart, index - tokenStart);
+            tokenStart = index + 1;
+        }
+    }
+    MessageManager::incomingMessage(MessageIncomming("serial", portName, 0, "", QString::fromLatin1(data, size), arguments));
+}
+void InterfaceSerial::parseFrames() {
+    //Sensor frames: 0xA5, count, count x int16 (little-endian), XOR of count and values
+    forever {
+        while((ringRead != ringWrite) && (ring[ringRead & INTERFACE_SERIAL_RING_MASK] != INTERFACE_SERIAL_FRAME_SYNC))
+            ringRead++;
+        quint32 pending = ringWrite - ringRead;
+        if(pending < 2)
+            break;
+        quint8  count = ring[(ringRead + 1) & INTERFACE_SERIAL_RING_MASK];
+        quint32 size  = 3 + 2 * count;
+        if(pending < size)
+            break;
+
+        quint8 checksum = 0;
+        for(quint32 index = 1 ; index < size - 1 ; index++)
+            checksum ^= ring[(ringRead + index) & INTERFACE_SERIAL_RING_MASK];
+        if((count == 0) || (checksum != (quint8)ring[(ringRead + size - 1) & INTERFACE_SERIAL_RING_MASK])) {
+            //Not a frame, resynchronize on the next header byte
+            ringRead++;
+            continue;
+        }
+
+        QStringList arguments;
+        arguments.reserve(count);
+        for(quint8 index = 0 ; index < count ; index++) {
+            quint8 low  = ring[(ringRead + 2 + 2*index)     & INTERFACE_SERIAL_RING_MASK];
+            quint8 high = ring[(ringRead + 2 + 2*index + 1) & INTERFACE_SERIAL_RING_MASK];
+            arguments << QString::number((qint16)(low | (high << 8)));
         }
+        ringRead += size;
+        MessageManager::incomingMessage(MessageIncomming("serial", portName, 0, "serial_raw", "", arguments));
     }
+    ringScan = ringRead;
 }
 
 bool InterfaceSerial::send(const Message &message, QStringList *messageSent) {
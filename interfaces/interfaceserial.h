@@ -30,6 +30,10 @@
 #include "qextserialport/qextserialport.h"
 #include "qextserialport/qextserialenumerator.h"
 
+#define INTERFACE_SERIAL_RING       65536
+#define INTERFACE_SERIAL_RING_MASK  (INTERFACE_SERIAL_RING-1)
+#define INTERFACE_SERIAL_FRAME_SYNC ((char)0xA5)
+
 namespace Ui {
 class InterfaceSerial;
 }
@@ -43,10 +47,11 @@ public:
 
 private:
     UiString portName;
-    UiReal portBaud, portBits, portParity, portStop, portFlow;
+    UiReal portBaud, portBits, portParity, portStop, portFlow, portFormat;
     UiBool enable;
 private slots:
     void portChanged();
+    void formatChanged();
     void openExamples() {
         QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(Application::pathPatches.absoluteFilePath() + "/Arduino/").absoluteFilePath()));
     }
@@ -61,7 +66,12 @@ private:
     QList<ParityType>   parityEnum;
     QList<StopBitsType> stopbitsEnum;
     QList<FlowType>     flowEnum;
-    QByteArray reception;
+    char ring[INTERFACE_SERIAL_RING];
+    quint32 ringRead, ringScan, ringWrite;
+    QByteArray line;
+    void parseLines();
+    void parseLine(quint32 start, quint32 end);
+    void parseFrames();
 private slots:
     void parse();
 
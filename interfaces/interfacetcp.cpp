@@ -20,7 +20,6 @@
     You should have received a copy of the GNU General Public License
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
-
 #include "interfacetcp.h"
 #include "ui_interfacetcp.h"
 
@@ -38,14 +37,24 @@ InterfaceTcp::InterfaceTcp(QWidget *parent) :
     enable.setAction(ui->enable, "interfaceTcpEnable");
     port.setAction(ui->port,     "interfaceTcpPort");
     connect(&port, SIGNAL(triggered(qreal)), SLOT(portChanged()));
-    type.setAction(QList<QRadioButton*>() << ui->typeRaw << ui->typeXml, "interfaceTcpXml");
+    type.setAction(QList<QRadioButton*>() << ui->typeRaw << ui->typeXml << ui->typeOsc << ui->typeOscSlip, "interfaceTcpXml");
     connect(&type, SIGNAL(triggered(qreal)), SLOT(typeChanged()));
     port = 3000;
+
+    //Throughput of each client
+    connect(&statsTimer, SIGNAL(timeout()), SLOT(refreshStats()));
+    statsTimer.start(1000);
 }
 
 InterfaceTcpServer::InterfaceTcpServer(QObject *parent) :
-    QTcpServer(parent) {
-    xmlMode = false;
+    QTcpServer(parent), stats("TCP") {
+    type   = InterfaceTcpTypeRaw;
+    bundle = false;
+    statsTimer.start();
+}
+InterfaceTcpServer::~InterfaceTcpServer() {
+    qDeleteAll(connections);
+    connections.clear();
 }
 
 void InterfaceTcp::portChanged() {
@@ -53,7 +62,11 @@ void InterfaceTcp::portChanged() {
     else                                    ui->port->setStyleSheet(ihmFeedbackNok);
 }
 void InterfaceTcp::typeChanged() {
-    tcpServer->xmlMode = (type.val() > 0);
+    tcpServer->type = type.val();
+
+    //Partial frames of the previous format are meaningless now
+    foreach(InterfaceTcpConnection *connection, tcpServer->connections)
+        connection->input.clear();
 }
 bool InterfaceTcpServer::portChanged(quint16 port) {
     //Initialization
@@ -67,14 +80,34 @@ bool InterfaceTcp::send(const Message &message, QStringList *messageSent) {
         return false;
     return tcpServer->send(message, messageSent);
 }
+void InterfaceTcp::networkBundle(bool start) {
+    //Writes of a whole scheduler tick are gathered and flushed once
+    tcpServer->bundle = start;
+    if(!start)
+        tcpServer->flush();
+}
 bool InterfaceTcpServer::send(const Message &message, QStringList *messageSent) {
+    if(sockets.isEmpty())
+        return false;
+
     bool ok = false;
     QByteArray bytes;
-    if(xmlMode) {
+    if(type == InterfaceTcpTypeXml) {
         //bytes += "<OSCPACKET ADDRESS=\"" + socket->localAddress().toString() + "\" PORT=\"" + QByteArray::number(socket->localPort()) + "\" TIME=\"" + QByteArray::number(Transport::timeLocal) + "\"><MESSAGE NAME=\"/" + message.getAddress() + "\">" + message.getAsciiMessageXml() + "</MESSAGE></OSCPACKET>";
         bytes += "<OSCPACKET TIME=\"" + QByteArray::number(Transport::timeLocal) + "\"><MESSAGE NAME=\"/" + message.getAddress() + "\">" + message.getAsciiMessageXml() + "</MESSAGE></OSCPACKET>";
         bytes += (char)0;
     }
+    else if(type == InterfaceTcpTypeOsc) {
+        //OSC 1.0 stream framing: big-endian int32 size before each packet
+        QByteArray packet = encodeOsc(message);
+        bytes.resize(4);
+        qToBigEndian<qint32>(packet.size(), (uchar*)bytes.data());
+        bytes += packet;
+    }
+    else if(type == InterfaceTcpTypeOscSlip) {
+        //OSC 1.1 stream framing: SLIP encoded packets
+        bytes = encodeSlip(encodeOsc(message));
+    }
     else {
         foreach(const QVariant &valeur, message.verboseValues) {
             bool isFloat = false;
@@ -93,8 +126,27 @@ bool InterfaceTcpServer::send(const Message &message, QStringList *messageSent)
 
     //Send request
     foreach(QTcpSocket *socket, sockets) {
-        socket->write(bytes);
-        socket->flush();
+        InterfaceTcpConnection *connection = connections.value(socket);
+        if(!connection)
+            continue;
+
+        //Slow client, its output buffer is full
+        if((socket->bytesToWrite() > INTERFACE_TCP_PENDING_MAX) && (MessageSender::dropPolicy == MessageDropWait))
+            socket->waitForBytesWritten(1);
+        qint64 pending = socket->bytesToWrite() + connection->output.size();
+        stats.setDepth(pending);
+        if(pending > INTERFACE_TCP_PENDING_MAX) {
+            stats.dropped++;
+            continue;
+        }
+
+        //No flush per message: gathered until the end of the tick, or left to the event loop
+        if(bundle)  connection->output += bytes;
+        else        socket->write(bytes);
+        connection->bytesOut += bytes.size();
+        connection->messagesOut++;
+        stats.queued++;
+        stats.sent.fetchAndAddRelaxed(1);
 
         //Log in console
         MessageManager::logSend(message, messageSent);
@@ -102,53 +154,305 @@ bool InterfaceTcpServer::send(const Message &message, QStringList *messageSent)
     }
     return ok;
 }
+void InterfaceTcpServer::flush() {
+    foreach(QTcpSocket *socket, sockets) {
+        InterfaceTcpConnection *connection = connections.value(socket);
+        if((connection) && (!connection->output.isEmpty())) {
+            socket->write(connection->output);
+            socket->flush();
+            connection->output.clear();
+        }
+    }
+}
+
+QByteArray InterfaceTcpServer::encodeOsc(const Message &message) const {
+    QByteArray address = "/" + message.getAddress(), typetag = ",", arguments;
+    address += (char)0;
+    while(address.size() % 4)
+        address += (char)0;
+
+    //Typed arguments from the values rendered by the message
+    foreach(const QVariant &value, message.verboseValues) {
+        uchar bytes[8];
+        if(value.type() == QVariant::String) {
+            arguments += value.toString().toUtf8();
+            arguments += (char)0;
+            while(arguments.size() % 4)
+                arguments += (char)0;
+            typetag += 's';
+        }
+        else if(value.type() == QVariant::LongLong) {
+            qToBigEndian<qint64>(value.toLongLong(), bytes);
+            arguments.append((const char*)bytes, 8);
+            typetag += 't';
+        }
+        else {
+            union { float f; quint32 i; } u;
+            u.f = value.toFloat();
+            qToBigEndian<quint32>(u.i, bytes);
+            arguments.append((const char*)bytes, 4);
+            typetag += 'f';
+        }
+    }
+    typetag += (char)0;
+    while(typetag.size() % 4)
+        typetag += (char)0;
+    return address + typetag + arguments;
+}
+QByteArray InterfaceTcpServer::encodeSlip(const QByteArray &packet) const {
+    QByteArray bytes;
+    bytes.reserve(packet.size() + 8);
+    bytes += INTERFACE_TCP_SLIP_END;
+    for(int index = 0 ; index < packet.size() ; index++) {
+        char c = packet.at(index);
+        if(c == INTERFACE_TCP_SLIP_END) {
+            bytes += INTERFACE_TCP_SLIP_ESC;
+            bytes += INTERFACE_TCP_SLIP_ESC_END;
+        }
+        else if(c == INTERFACE_TCP_SLIP_ESC) {
+            bytes += INTERFACE_TCP_SLIP_ESC;
+            bytes += INTERFACE_TCP_SLIP_ESC_ESC;
+        }
+        else
+            bytes += c;
+    }
+    bytes += INTERFACE_TCP_SLIP_END;
+    return bytes;
+}
+QByteArray InterfaceTcpServer::decodeSlip(const char *data, int size) const {
+    QByteArray packet;
+    packet.reserve(size);
+    for(int index = 0 ; index < size ; index++) {
+        if((data[index] == INTERFACE_TCP_SLIP_ESC) && (index+1 < size)) {
+            index++;
+            if(data[index] == INTERFACE_TCP_SLIP_ESC_END)       packet += INTERFACE_TCP_SLIP_END;
+            else if(data[index] == INTERFACE_TCP_SLIP_ESC_ESC)  packet += INTERFACE_TCP_SLIP_ESC;
+            else                                                packet += data[index];
+        }
+        else
+            packet += data[index];
+    }
+    return packet;
+}
 
 
 //TCP reception
 #ifdef QT4
 void InterfaceTcpServer::incomingConnection(int handle) {
-    QTcpSocket *socket = new QTcpSocket(this);
-    connect(socket, SIGNAL(readyRead()),    this, SLOT(readClient()));
-    connect(socket, SIGNAL(disconnected()), this, SLOT(discardClient()));
-    socket->setSocketDescriptor(handle);
-    sockets.append(socket);
-    emit(updateConnectedClients());
-}
 #else
 void InterfaceTcpServer::incomingConnection(qintptr handle) {
+#endif
     QTcpSocket *socket = new QTcpSocket(this);
-    connect(socket, SIGNAL(readyRead()),    this, SLOT(readClient()));
-    connect(socket, SIGNAL(disconnected()), this, SLOT(discardClient()));
+    connect(socket, SIGNAL(readyRead()),         this, SLOT(readClient()));
+    connect(socket, SIGNAL(disconnected()),      this, SLOT(discardClient()));
+    connect(socket, SIGNAL(destroyed(QObject*)), this, SLOT(socketDestroyed(QObject*)));
     socket->setSocketDescriptor(handle);
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
     sockets.append(socket);
+    connections.insert(socket, new InterfaceTcpConnection());
     emit(updateConnectedClients());
 }
-#endif
 void InterfaceTcpServer::readClient() {
     QTcpSocket *socket = (QTcpSocket*)sender();
-    if(socket->isReadable()) {
-        if(xmlMode) {
-            //XML parsing
-            QDomDocument xmlDoc;
-            xmlDoc.setContent(socket->readAll());
-            emit(parseXml(xmlDoc, socket));
+    InterfaceTcpConnection *connection = connections.value(socket);
+    if((!connection) || (!socket->isReadable()))
+        return;
+
+    //Reassembly buffer: incomplete frames wait for the next chunk
+    QByteArray dataReceived = socket->readAll();
+    connection->bytesIn += dataReceived.size();
+    QByteArray input = connection->input + dataReceived;
+    connection->input.clear();
+    int index = 0;
+
+    if(type == InterfaceTcpTypeXml) {
+        //XML parsing, one document per null-terminated frame
+        forever {
+            int end = input.indexOf((char)0, index);
+            if(end < 0) {
+                //Legacy clients without terminator
+                if(input.trimmed().toUpper().endsWith("</OSCPACKET>"))
+                    end = input.size();
+                else
+                    break;
+            }
+            if(end > index) {
+                QDomDocument xmlDoc;
+                xmlDoc.setContent(input.mid(index, end - index));
+                connection->messagesIn++;
+                emit(parseXml(xmlDoc, socket));
+            }
+            index = end + 1;
+            if(index >= input.size())
+                break;
         }
-        else {
-            //RAW data
-            QByteArray dataReceived = socket->readAll();
+    }
+    else if(type == InterfaceTcpTypeOsc) {
+        //Size-prefixed OSC packets
+        while(input.size() - index >= 4) {
+            qint32 size = qFromBigEndian<qint32>((const uchar*)input.constData() + index);
+            if((size <= 0) || (size > INTERFACE_TCP_PACKET_MAX)) {
+                qDebug("[TCP] Invalid OSC packet size (%d), closing connection", size);
+                socket->abort();
+                return;
+            }
+            if(input.size() - index - 4 < size)
+                break;
+            parseOsc(socket, connection, input.constData() + index + 4, size);
+            index += 4 + size;
+        }
+    }
+    else if(type == InterfaceTcpTypeOscSlip) {
+        //SLIP-delimited OSC packets (double END accepted)
+        forever {
+            int end = input.indexOf(INTERFACE_TCP_SLIP_END, index);
+            if(end < 0)
+                break;
+            if(end > index) {
+                QByteArray packet = decodeSlip(input.constData() + index, end - index);
+                parseOsc(socket, connection, packet.constData(), packet.size());
+            }
+            index = end + 1;
+        }
+        if(input.size() - index > INTERFACE_TCP_PACKET_MAX) {
+            qDebug("[TCP] SLIP packet too large, closing connection");
+            socket->abort();
+            return;
+        }
+    }
+    else {
+        //RAW data, only whole floats are consumed
+        int size = input.size() - input.size() % 4;
+        if(size > 0) {
             QStringList arguments;
-            for(quint16 indexBuffer = 0 ; indexBuffer < dataReceived.count() ; indexBuffer += 4) {
+            for(index = 0 ; index < size ; index += 4) {
                 union { float f; char ch[4]; } u;
-                u.ch[0] = dataReceived[indexBuffer + 0];
-                u.ch[1] = dataReceived[indexBuffer + 1];
-                u.ch[2] = dataReceived[indexBuffer + 2];
-                u.ch[3] = dataReceived[indexBuffer + 3];
+                u.ch[0] = input[index + 0];
+                u.ch[1] = input[index + 1];
+                u.ch[2] = input[index + 2];
+                u.ch[3] = input[index + 3];
                 qreal val = u.f;
                 arguments << QString::number(val);
             }
+            connection->messagesIn++;
             MessageManager::incomingMessage(MessageIncomming("tcp", socket->peerAddress().toString(), socket->peerPort(), "tcp_raw", "", arguments));
         }
     }
+
+    //Keep the remaining partial frame
+    if((index < input.size()) && (connections.value(socket) == connection))
+        connection->input = input.mid(index);
+}
+void InterfaceTcpServer::parseOsc(QTcpSocket *socket, InterfaceTcpConnection *connection, const char *data, int size, quint8 depth) {
+    //Bundle: timetag followed by size-prefixed elements
+    if((size >= 16) && (qstrncmp(data, "#bundle", 8) == 0)) {
+        if(depth > 8)
+            return;
+        int index = 16;
+        while(size - index >= 4) {
+            qint32 elementSize = qFromBigEndian<qint32>((const uchar*)data + index);
+            index += 4;
+            if((elementSize <= 0) || (elementSize > size - index))
+                break;
+            parseOsc(socket, connection, data + index, elementSize, depth + 1);
+            index += elementSize;
+        }
+        return;
+    }
+
+    //OSC address
+    if((size < 4) || (data[0] != '/'))
+        return;
+    int index = 0;
+    while((index < size) && (data[index] != 0))
+        index++;
+    if(index >= size)
+        return;
+    QString commandDestination = QString::fromLatin1(data, index).remove("/iannix/").remove("/transport/");
+    index = (index + 4) & ~3;
+
+    //OSC arguments type
+    const char *typetag = "";
+    int typetagSize = 0;
+    if((index < size) && (data[index] == ',')) {
+        typetag = data + index + 1;
+        while((index < size) && (data[index] != 0))
+            index++;
+        if(index >= size)
+            return;
+        typetagSize = (data + index) - typetag;
+        index = (index + 4) & ~3;
+    }
+
+    //Parse content
+    QString command = commandDestination + " ";
+    QStringList commandArguments;
+    for(int indexTypetag = 0 ; indexTypetag < typetagSize ; indexTypetag++) {
+        QString commandValue;
+        char tag = typetag[indexTypetag];
+        if((tag == 'i') || (tag == 'c') || (tag == 'r') || (tag == 'm')) {
+            if(size - index < 4)
+                return;
+            qint32 value = qFromBigEndian<qint32>((const uchar*)data + index);
+            if(tag == 'c')  commandValue = QChar(value);
+            else            commandValue = QString::number(value);
+            index += 4;
+        }
+        else if(tag == 'f') {
+            if(size - index < 4)
+                return;
+            union { float f; quint32 i; } u;
+            u.i = qFromBigEndian<quint32>((const uchar*)data + index);
+            commandValue = QString::number(u.f);
+            index += 4;
+        }
+        else if((tag == 'h') || (tag == 't')) {
+            if(size - index < 8)
+                return;
+            commandValue = QString::number(qFromBigEndian<qint64>((const uchar*)data + index));
+            index += 8;
+        }
+        else if(tag == 'd') {
+            if(size - index < 8)
+                return;
+            union { double d; quint64 i; } u;
+            u.i = qFromBigEndian<quint64>((const uchar*)data + index);
+            commandValue = QString::number(u.d);
+            index += 8;
+        }
+        else if((tag == 's') || (tag == 'S')) {
+            int start = index;
+            while((index < size) && (data[index] != 0))
+                index++;
+            if(index >= size)
+                return;
+            commandValue = QString::fromUtf8(data + start, index - start);
+            index = (index + 4) & ~3;
+        }
+        else if(tag == 'b') {
+            //Blobs are skipped
+            if(size - index < 4)
+                return;
+            qint32 blobSize = qFromBigEndian<qint32>((const uchar*)data + index);
+            if((blobSize < 0) || (blobSize > size - index - 4))
+                return;
+            index = (index + 4 + blobSize + 3) & ~3;
+            continue;
+        }
+        else if(tag == 'T')
+            commandValue = "1";
+        else if(tag == 'F')
+            commandValue = "0";
+        else if((tag == 'N') || (tag == 'I'))
+            continue;
+        else
+            return;
+        command += commandValue + " ";
+        commandArguments << commandValue;
+    }
+
+    connection->messagesIn++;
+    MessageManager::incomingMessage(MessageIncomming("tcp", socket->peerAddress().toString(), socket->peerPort(), commandDestination, command, commandArguments));
 }
 
 void InterfaceTcp::parseXml(const QDomDocument &xmlDoc, QTcpSocket *socket) {
@@ -183,17 +487,52 @@ void InterfaceTcpServer::discardClient() {
     emit(updateConnectedClients());
     socket->deleteLater();
 }
+void InterfaceTcpServer::socketDestroyed(QObject *object) {
+    delete connections.take((QTcpSocket*)object);
+}
 
 
+void InterfaceTcpServer::refreshStats() {
+    qreal elapsed = statsTimer.restart() / 1000.;
+    if(elapsed <= 0)
+        return;
+    foreach(InterfaceTcpConnection *connection, connections) {
+        connection->bytesInRate     = (connection->bytesIn     - connection->bytesInLast)     / elapsed;
+        connection->bytesOutRate    = (connection->bytesOut    - connection->bytesOutLast)    / elapsed;
+        connection->messagesInRate  = (connection->messagesIn  - connection->messagesInLast)  / elapsed;
+        connection->messagesOutRate = (connection->messagesOut - connection->messagesOutLast) / elapsed;
+        connection->bytesInLast     = connection->bytesIn;
+        connection->bytesOutLast    = connection->bytesOut;
+        connection->messagesInLast  = connection->messagesIn;
+        connection->messagesOutLast = connection->messagesOut;
+    }
+}
+void InterfaceTcp::refreshStats() {
+    tcpServer->refreshStats();
+    if(isVisible())
+        updateConnectedClients();
+}
 void InterfaceTcp::updateConnectedClients() {
-    QString clients;
-    foreach(QTcpSocket *socket, tcpServer->sockets)
+    QString clients, clientsStats;
+    qreal bytesIn = 0, bytesOut = 0;
+    foreach(QTcpSocket *socket, tcpServer->sockets) {
+        InterfaceTcpConnection *connection = tcpServer->connections.value(socket);
         clients += QString("%1:%2\n").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+        if(connection) {
+            clientsStats += QString("%1:%2 - in %3 kB/s (%4 msg/s), out %5 kB/s (%6 msg/s)\n").arg(socket->peerAddress().toString()).arg(socket->peerPort())
+                    .arg(connection->bytesInRate  / 1024., 0, 'f', 1).arg(connection->messagesInRate,  0, 'f', 0)
+                    .arg(connection->bytesOutRate / 1024., 0, 'f', 1).arg(connection->messagesOutRate, 0, 'f', 0);
+            bytesIn  += connection->bytesInRate;
+            bytesOut += connection->bytesOutRate;
+        }
+    }
     clients.chop(1);
+    clientsStats.chop(1);
+    QString throughput = tr("in %1 kB/s, out %2 kB/s").arg(bytesIn / 1024., 0, 'f', 1).arg(bytesOut / 1024., 0, 'f', 1);
     if(tcpServer->sockets.count() == 0)        ui->clients->setText(tr("No client connected"));
-    else if(tcpServer->sockets.count() == 1)   ui->clients->setText(tr("1 client connected\n(%1)").arg(clients));
-    else                                       ui->clients->setText(tr("%1 clients connected").arg(tcpServer->sockets.count()));
-    ui->clients->setToolTip(clients);
+    else if(tcpServer->sockets.count() == 1)   ui->clients->setText(tr("1 client connected\n(%1)\n%2").arg(clients).arg(throughput));
+    else                                       ui->clients->setText(tr("%1 clients connected\n%2").arg(tcpServer->sockets.count()).arg(throughput));
+    ui->clients->setToolTip(clientsStats);
 }
 
 
@@ -25,26 +25,65 @@
 #define INTERFACETCP_H
 
 #include <QTcpServer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QtEndian>
 #include <QDomDocument>
 #include "misc/options.h"
 #include "messages/messagemanager.h"
 
+#define INTERFACE_TCP_PENDING_MAX   (1024*1024)
+#define INTERFACE_TCP_PACKET_MAX    (1024*1024)
+
+#define INTERFACE_TCP_SLIP_END      ((char)0xC0)
+#define INTERFACE_TCP_SLIP_ESC      ((char)0xDB)
+#define INTERFACE_TCP_SLIP_ESC_END  ((char)0xDC)
+#define INTERFACE_TCP_SLIP_ESC_ESC  ((char)0xDD)
+
+enum InterfaceTcpType { InterfaceTcpTypeRaw = 0, InterfaceTcpTypeXml = 1, InterfaceTcpTypeOsc = 2, InterfaceTcpTypeOscSlip = 3 };
+
 namespace Ui {
 class InterfaceTcp;
 }
 
+class InterfaceTcpConnection {
+public:
+    InterfaceTcpConnection() {
+        bytesIn = bytesOut = messagesIn = messagesOut = 0;
+        bytesInLast = bytesOutLast = messagesInLast = messagesOutLast = 0;
+        bytesInRate = bytesOutRate = messagesInRate = messagesOutRate = 0;
+    }
+public:
+    QByteArray input, output;
+    quint64 bytesIn,     bytesOut,     messagesIn,     messagesOut;
+    quint64 bytesInLast, bytesOutLast, messagesInLast, messagesOutLast;
+    qreal   bytesInRate, bytesOutRate, messagesInRate, messagesOutRate;
+};
+
 class InterfaceTcpServer : public QTcpServer {
     Q_OBJECT
 
 public:
     InterfaceTcpServer(QObject *parent);
+    ~InterfaceTcpServer();
 
 public:
-    bool xmlMode;
+    quint8 type;
+    bool bundle;
     QList<QTcpSocket*> sockets;
+    QHash<QTcpSocket*, InterfaceTcpConnection*> connections;
+    MessageSenderStats stats;
     bool send(const Message &message, QStringList *messageSent = 0);
+    void flush();
+    void refreshStats();
 public:
     bool portChanged(quint16 port);
+private:
+    QElapsedTimer statsTimer;
+    QByteArray encodeOsc(const Message &message) const;
+    QByteArray encodeSlip(const QByteArray &packet) const;
+    QByteArray decodeSlip(const char *data, int size) const;
+    void parseOsc(QTcpSocket *socket, InterfaceTcpConnection *connection, const char *data, int size, quint8 depth = 0);
 protected:
 #ifdef QT4
     void incomingConnection(int handle);
@@ -54,6 +93,7 @@ protected:
 private slots:
     void readClient();
     void discardClient();
+    void socketDestroyed(QObject *object);
 signals:
     void updateConnectedClients();
     void parseXml(const QDomDocument&, QTcpSocket*);
@@ -71,10 +111,12 @@ private:
     UiReal port;
     UiBool enable;
     UiReal type;
+    QTimer statsTimer;
 private slots:
     void portChanged();
     void typeChanged();
     void updateConnectedClients();
+    void refreshStats();
     void parseXml(const QDomDocument&, QTcpSocket*);
     void openExamples() {
         QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(Application::pathPatches.absoluteFilePath() + "/Adobe Flash/").absoluteFilePath()));
@@ -82,6 +124,7 @@ private slots:
 
 public:
     bool send(const Message &message, QStringList *messageSent = 0);
+    void networkBundle(bool start);
 
 private:
     Ui::InterfaceTcp *ui;
@@ -30,6 +30,7 @@ InterfaceUdp::InterfaceUdp(QWidget *parent) :
     ui->setupUi(this);
     connect(ui->examples, SIGNAL(released()), SLOT(openExamples()));
     socket = 0;
+    sender = new MessageSender("UDP", this);
 
     //Interfaces link
     enable.setAction(ui->enable, "interfaceUdpEnable");
@@ -46,7 +47,8 @@ void InterfaceUdp::portChanged() {
     socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
     connect(socket, SIGNAL(readyRead()), SLOT(parseOSC()));
 
-    if(socket->bind(port))  ui->port->setStyleSheet(ihmFeedbackOk);
+    sender->setPort(port);
+    if(socket->bind(port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))  ui->port->setStyleSheet(ihmFeedbackOk);
     else                    ui->port->setStyleSheet(ihmFeedbackNok);
 }
 
@@ -75,8 +77,8 @@ bool InterfaceUdp::send(const Message &message, QStringList *messageSent) {
     if(!enable)
         return false;
 
-    //Write a message on the opened socket
-    socket->writeDatagram(message.getAsciiMessage() + ';' + '\n', message.getHost(), message.getPort());
+    //Queue the message for the sender thread
+    sender->push(message.getAsciiMessage(), message.getHost(), message.getPort(), ";\n");
 
     //Log in console
     MessageManager::logSend(message, messageSent);
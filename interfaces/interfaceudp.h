@@ -50,6 +50,7 @@ private slots:
 
 private:
     QUdpSocket *socket;
+    MessageSender *sender;
     char bufferI[4096];
     quint16 bufferISize;
 private slots:
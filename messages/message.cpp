@@ -26,11 +26,19 @@
 #include "objects/nxcursor.h"
 #include "objects/nxcurve.h"
 
+static const QByteArray messageArgumentScript("script %1");
+static const QByteArray messageArgumentCustom("custom %1");
+
 Message::Message() {
     type = MessagesTypeDirect;
+    artnetUniverse = 0;
+    artnetChannel = 1;
     hasAdd = false;
     messageScriptEngine = 0;
     isTransportMessage = false;
+    verbose = true;
+    cacheRevision = 0;
+    logId = -1;
 }
 
 void Message::setUrl(QString url, QScriptEngine *_messageScriptEngine, const QHash<QString,UiString> &aliases) {
@@ -45,8 +53,9 @@ void Message::setUrl(const QUrl & url, QScriptEngine *_messageScriptEngine) {
     messageScriptEngine = _messageScriptEngine;
     if(messageScriptEngine)
         messageScriptValue = messageScriptEngine->globalObject();
+    scripts.clear();
     hasAdd = false;
-    urlMessage = url;
+    urlMessage = urlMessageBase = url;
 
     QString scheme = urlMessage.scheme().toLower();
     urlMessageString = qPrintable(urlMessage.toString());
@@ -56,6 +65,15 @@ void Message::setUrl(const QUrl & url, QScriptEngine *_messageScriptEngine) {
     asciiMessage.clear();
     asciiMessageXml.clear();
 
+    //Buffers are reused from one send to the other (capacity is kept by resize(0))
+    typetag        .reserve(32);
+    arguments      .reserve(256);
+    buffer         .reserve(512);
+    asciiMessage   .reserve(256);
+    asciiMessageXml.reserve(1024);
+    verboseValues  .reserve(16);
+    midiValues     .reserve(8);
+
     if(scheme == "osc") {
         type = MessagesTypeOsc;
         host = urlMessage.host().toLower();
@@ -88,17 +106,38 @@ void Message::setUrl(const QUrl & url, QScriptEngine *_messageScriptEngine) {
         midiPort = urlMessage.host().toLower();
         midiCommand = urlMessage.path().toLower();
     }
+    else if(scheme == "artnet") {
+        //artnet://universe/channel, numerical hosts may have been normalized as IPv4 addresses
+        type = MessagesTypeArtnet;
+        bool ok = false;
+        artnetUniverse = urlMessage.host().toUInt(&ok);
+        if(!ok)
+            artnetUniverse = QHostAddress(urlMessage.host()).toIPv4Address();
+        artnetUniverse &= 0x7FFF;
+        artnetChannel  = qBound(1, urlMessage.path().remove("/").toInt(), 512);
+    }
 }
 
 
-bool Message::parse(const QVector<QByteArray> & patternItems, const MessageManagerDestination &destination) {
+bool Message::parse(const QVector<QByteArray> & patternItems, const MessageManagerDestination &destination, bool _verbose) {
     bool suppressSend = false;
-    midiValues   .clear();
-    asciiMessage .clear();
-    verboseValues.clear();
-    verboseValues.reserve(patternItems.count());
-    buffer       .clear();
+    //Verbose values are only rendered for log sinks (TCP raw mode and MIDI use them as values)
+    verbose = (_verbose) || (type == MessagesTypeTcp) || (type == MessagesTypeMidi);
+    midiValues     .resize(0);
+    asciiMessage   .resize(0);
+    asciiMessageXml.resize(0);
+    verboseValues  .resize(0);
+    buffer         .resize(0);
+    arguments      .resize(0);
+    typetag        .resize(0);
+    if(type == MessagesTypeOsc)
+        typetag += ',';
+    else if(type == MessagesTypeHttp)
+        urlMessage = urlMessageBase;
     hasAdd = false;
+    isTransportMessage = false;
+    if(destination.object) logId = ((NxObject*)destination.object)->getId();
+    else                   logId = -1;
 
     if(patternItems.count() >= 2) {
         //Messages
@@ -107,227 +146,21 @@ bool Message::parse(const QVector<QByteArray> & patternItems, const MessageManag
             bool found = false;
 
             if((patternArgument.at(0) == '{') && (messageScriptEngine)) {
-                patternArgument = patternArgument.trimmed().remove(0, 1);
-                patternArgument.chop(1);
-
-                if(((NxTrigger*)destination.trigger)) {
-                    if(patternArgument.contains("trigger_id"))
-                        messageScriptValue.setProperty("trigger_id", ((NxTrigger*)destination.trigger)->getId());
-                    if(patternArgument.contains("trigger_group_id"))
-                        messageScriptValue.setProperty("trigger_group_id", ((NxTrigger*)destination.trigger)->getGroupId());
-                    if(patternArgument.contains("trigger_label"))
-                        messageScriptValue.setProperty("trigger_label", ((NxTrigger*)destination.trigger)->getLabel());
-                    if(patternArgument.contains("trigger_xPos"))
-                        messageScriptValue.setProperty("trigger_xPos", ((NxTrigger*)destination.trigger)->getPos().x());
-                    if(patternArgument.contains("trigger_yPos"))
-                        messageScriptValue.setProperty("trigger_yPos", ((NxTrigger*)destination.trigger)->getPos().y());
-                    if(patternArgument.contains("trigger_zPos"))
-                        messageScriptValue.setProperty("trigger_zPos", ((NxTrigger*)destination.trigger)->getPos().z());
-                    if((patternArgument.contains("trigger_value_x")) && (((NxCursor*)destination.cursor)))
-                        messageScriptValue.setProperty("trigger_value_x", ((NxCursor*)destination.cursor)->getCursorValue(((NxTrigger*)destination.trigger)->getPos()).x());
-                    if((patternArgument.contains("trigger_value_y")) && (((NxCursor*)destination.cursor)))
-                        messageScriptValue.setProperty("trigger_value_y", ((NxCursor*)destination.cursor)->getCursorValue(((NxTrigger*)destination.trigger)->getPos()).y());
-                    if((patternArgument.contains("trigger_value_z")) && (((NxCursor*)destination.cursor)))
-                        messageScriptValue.setProperty("trigger_value_z", ((NxCursor*)destination.cursor)->getCursorValue(((NxTrigger*)destination.trigger)->getPos()).z());
-                    if(patternArgument.contains("trigger_value"))
-                        messageScriptValue.setProperty("trigger_value", ((NxTrigger*)destination.trigger)->getTrigged());
-                    if(patternArgument.contains("trigger_duration"))
-                        messageScriptValue.setProperty("trigger_duration", ((NxTrigger*)destination.trigger)->getTriggerOff());
-                    if((patternArgument.contains("trigger_distance")) && (((NxCursor*)destination.cursor))) {
-                        NxPoint cursorPosDelta = ((NxTrigger*)destination.trigger)->getPos() - ((NxCursor*)destination.cursor)->getCurrentPos();
-                        messageScriptValue.setProperty("trigger_distance", qSqrt(cursorPosDelta.x()*cursorPosDelta.x() + cursorPosDelta.y()*cursorPosDelta.y() + cursorPosDelta.z()*cursorPosDelta.z()));
-                    }
-                    if((patternArgument.contains("trigger_side")) && (((NxCursor*)destination.cursor))) {
-                        qreal cursorAngle = fmod(((NxCursor*)destination.cursor)->getCurrentAngle().z(), 360);
-                        float side = 0;
-                        if(cursorAngle == 90) //cursor going straight up
-                            side = (((NxTrigger*)destination.trigger)->getPos().x() > ((NxCursor*)destination.cursor)->getCurrentPos().x()) ? 1:0;
-                        else if (cursorAngle == 270) //cursor going straight down
-                            side = (((NxTrigger*)destination.trigger)->getPos().x() > ((NxCursor*)destination.cursor)->getCurrentPos().x()) ? 0:1;
-                        else if(((0<cursorAngle) && (cursorAngle<90)) || ((270<cursorAngle) && (cursorAngle<360)) ) //cursor going to left
-                            side = (((NxTrigger*)destination.trigger)->getPos().y() > ((NxCursor*)destination.cursor)->getCurrentPos().y()) ? 1:0;
-                        else //cursor going to right
-                            side = (((NxTrigger*)destination.trigger)->getPos().y() > ((NxCursor*)destination.cursor)->getCurrentPos().y()) ? 0:1;
-                        messageScriptValue.setProperty("trigger_side", side);
-                    }
-                    if(patternArgument.contains("trigger_message_id"))
-                        messageScriptValue.setProperty("trigger_message_id", (quint32)((NxTrigger*)destination.trigger)->getMessageId());
-                }
-                if(((NxCursor*)destination.cursor)) {
-                    if(patternArgument.contains("cursor_id"))
-                        messageScriptValue.setProperty("cursor_id", ((NxCursor*)destination.cursor)->getId());
-                    if(patternArgument.contains("cursor_group_id"))
-                        messageScriptValue.setProperty("cursor_group_id", ((NxCursor*)destination.cursor)->getGroupId());
-                    if(patternArgument.contains("cursor_label"))
-                        messageScriptValue.setProperty("cursor_label", ((NxCursor*)destination.cursor)->getLabel());
-
-                    if(patternArgument.contains("cursor_xPos"))
-                        messageScriptValue.setProperty("cursor_xPos", ((NxCursor*)destination.cursor)->getCurrentPos().x());
-                    if(patternArgument.contains("cursor_yPos"))
-                        messageScriptValue.setProperty("cursor_yPos", ((NxCursor*)destination.cursor)->getCurrentPos().y());
-                    if(patternArgument.contains("cursor_zPos"))
-                        messageScriptValue.setProperty("cursor_zPos", ((NxCursor*)destination.cursor)->getCurrentPos().z());
-                    if(patternArgument.contains("cursor_value_x"))
-                        messageScriptValue.setProperty("cursor_value_x", ((NxCursor*)destination.cursor)->getCurrentValue().x());
-                    if(patternArgument.contains("cursor_value_y"))
-                        messageScriptValue.setProperty("cursor_value_y", ((NxCursor*)destination.cursor)->getCurrentValue().y());
-                    if(patternArgument.contains("cursor_value_z"))
-                        messageScriptValue.setProperty("cursor_value_z", ((NxCursor*)destination.cursor)->getCurrentValue().z());
-
-                    if(patternArgument.contains("cursor_aPos"))
-                        messageScriptValue.setProperty("cursor_aPos", ((NxCursor*)destination.cursor)->getCurrentAed().x());
-                    if(patternArgument.contains("cursor_ePos"))
-                        messageScriptValue.setProperty("cursor_ePos", ((NxCursor*)destination.cursor)->getCurrentAed().y());
-                    if(patternArgument.contains("cursor_dPos"))
-                        messageScriptValue.setProperty("cursor_dPos", ((NxCursor*)destination.cursor)->getCurrentAed().z());
-                    if(patternArgument.contains("cursor_value_a"))
-                        messageScriptValue.setProperty("cursor_value_a", ((NxCursor*)destination.cursor)->getCurrentValueAed().x());
-                    if(patternArgument.contains("cursor_value_e"))
-                        messageScriptValue.setProperty("cursor_value_e", ((NxCursor*)destination.cursor)->getCurrentValueAed().y());
-                    if(patternArgument.contains("cursor_value_d"))
-                        messageScriptValue.setProperty("cursor_value_d", ((NxCursor*)destination.cursor)->getCurrentValueAed().z());
-
-                    if(patternArgument.contains("cursor_sxPos"))
-                        messageScriptValue.setProperty("cursor_sxPos", ((NxCursor*)destination.cursor)->getCurrentPos().sx());
-                    if(patternArgument.contains("cursor_syPos"))
-                        messageScriptValue.setProperty("cursor_syPos", ((NxCursor*)destination.cursor)->getCurrentPos().sy());
-                    if(patternArgument.contains("cursor_szPos"))
-                        messageScriptValue.setProperty("cursor_szPos", ((NxCursor*)destination.cursor)->getCurrentPos().sz());
-                    if(patternArgument.contains("cursor_value_sx"))
-                        messageScriptValue.setProperty("cursor_value_sx", ((NxCursor*)destination.cursor)->getCurrentValue().sx());
-                    if(patternArgument.contains("cursor_value_sy"))
-                        messageScriptValue.setProperty("cursor_value_sy", ((NxCursor*)destination.cursor)->getCurrentValue().sy());
-                    if(patternArgument.contains("cursor_value_sz"))
-                        messageScriptValue.setProperty("cursor_value_sz", ((NxCursor*)destination.cursor)->getCurrentValue().sz());
-                    if(patternArgument.contains("cursor_time"))
-                        messageScriptValue.setProperty("cursor_time", ((NxCursor*)destination.cursor)->getTimeLocal());
-                    if(patternArgument.contains("cursor_time_percent"))
-                        messageScriptValue.setProperty("cursor_time_percent", ((NxCursor*)destination.cursor)->getTimeLocalPercent());
-                    if(patternArgument.contains("cursor_angle"))
-                        messageScriptValue.setProperty("cursor_angle", fmod(((NxCursor*)destination.cursor)->getCurrentAngle().z(), 360));
-
-                    if(patternArgument.contains("cursor_xPos_delta"))
-                        messageScriptValue.setProperty("cursor_xPos_delta",     ((NxCursor*)destination.cursor)->getCurrentPos().x()    - ((NxCursor*)destination.cursor)->getCurrentPosLastSend().x());
-                    if(patternArgument.contains("cursor_yPos_delta"))
-                        messageScriptValue.setProperty("cursor_yPos_delta",     ((NxCursor*)destination.cursor)->getCurrentPos().y()    - ((NxCursor*)destination.cursor)->getCurrentPosLastSend().y());
-                    if(patternArgument.contains("cursor_zPos_delta"))
-                        messageScriptValue.setProperty("cursor_zPos_delta",     ((NxCursor*)destination.cursor)->getCurrentPos().z()    - ((NxCursor*)destination.cursor)->getCurrentPosLastSend().z());
-                    if(patternArgument.contains("cursor_value_x_delta"))
-                        messageScriptValue.setProperty("cursor_value_x_delta",  ((NxCursor*)destination.cursor)->getCurrentValue().x()  - ((NxCursor*)destination.cursor)->getCurrentValueLastSend().x());
-                    if(patternArgument.contains("cursor_value_y_delta"))
-                        messageScriptValue.setProperty("cursor_value_y_delta",  ((NxCursor*)destination.cursor)->getCurrentValue().y()  - ((NxCursor*)destination.cursor)->getCurrentValueLastSend().y());
-                    if(patternArgument.contains("cursor_value_z_delta"))
-                        messageScriptValue.setProperty("cursor_value_z_delta",  ((NxCursor*)destination.cursor)->getCurrentValue().z()  - ((NxCursor*)destination.cursor)->getCurrentValueLastSend().z());
-
-                    if(patternArgument.contains("cursor_aPos_delta"))
-                        messageScriptValue.setProperty("cursor_aPos_delta",     ((NxCursor*)destination.cursor)->getCurrentAed().x()    - ((NxCursor*)destination.cursor)->getCurrentAedLastSend().x());
-                    if(patternArgument.contains("cursor_ePos_delta"))
-                        messageScriptValue.setProperty("cursor_ePos_delta",     ((NxCursor*)destination.cursor)->getCurrentAed().y()    - ((NxCursor*)destination.cursor)->getCurrentAedLastSend().y());
-                    if(patternArgument.contains("cursor_dPos_delta"))
-                        messageScriptValue.setProperty("cursor_dPos_delta",     ((NxCursor*)destination.cursor)->getCurrentAed().z()    - ((NxCursor*)destination.cursor)->getCurrentAedLastSend().z());
-                    if(patternArgument.contains("cursor_value_a_delta"))
-                        messageScriptValue.setProperty("cursor_value_a_delta",  ((NxCursor*)destination.cursor)->getCurrentValueAed().x()  - ((NxCursor*)destination.cursor)->getCurrentValueAedLastSend().x());
-                    if(patternArgument.contains("cursor_value_e_delta"))
-                        messageScriptValue.setProperty("cursor_value_e_delta",  ((NxCursor*)destination.cursor)->getCurrentValueAed().y()  - ((NxCursor*)destination.cursor)->getCurrentValueAedLastSend().y());
-                    if(patternArgument.contains("cursor_value_d_delta"))
-                        messageScriptValue.setProperty("cursor_value_d_delta",  ((NxCursor*)destination.cursor)->getCurrentValueAed().z()  - ((NxCursor*)destination.cursor)->getCurrentValueAedLastSend().z());
-
-                    if(patternArgument.contains("cursor_sxPos_delta"))
-                        messageScriptValue.setProperty("cursor_sxPos_delta",    ((NxCursor*)destination.cursor)->getCurrentPos().sx()   - ((NxCursor*)destination.cursor)->getCurrentPosLastSend().sx());
-                    if(patternArgument.contains("cursor_syPos_delta"))
-                        messageScriptValue.setProperty("cursor_syPos_delta",    ((NxCursor*)destination.cursor)->getCurrentPos().sy()   - ((NxCursor*)destination.cursor)->getCurrentPosLastSend().sy());
-                    if(patternArgument.contains("cursor_szPos_delta"))
-                        messageScriptValue.setProperty("cursor_szPos_delta",    ((NxCursor*)destination.cursor)->getCurrentPos().sz()   - ((NxCursor*)destination.cursor)->getCurrentPosLastSend().sz());
-                    if(patternArgument.contains("cursor_value_sx_delta"))
-                        messageScriptValue.setProperty("cursor_value_sx_delta", ((NxCursor*)destination.cursor)->getCurrentValue().sx() - ((NxCursor*)destination.cursor)->getCurrentValueLastSend().sx());
-                    if(patternArgument.contains("cursor_value_sy_delta"))
-                        messageScriptValue.setProperty("cursor_value_sy_delta", ((NxCursor*)destination.cursor)->getCurrentValue().sy() - ((NxCursor*)destination.cursor)->getCurrentValueLastSend().sy());
-                    if(patternArgument.contains("cursor_value_sz_delta"))
-                        messageScriptValue.setProperty("cursor_value_sz_delta", ((NxCursor*)destination.cursor)->getCurrentValue().sz() - ((NxCursor*)destination.cursor)->getCurrentValueLastSend().sz());
-                    if(patternArgument.contains("cursor_time_delta"))
-                        messageScriptValue.setProperty("cursor_time_delta",         ((NxCursor*)destination.cursor)->getTimeLocal()        - ((NxCursor*)destination.cursor)->getTimeLocalLastSend());
-                    if(patternArgument.contains("cursor_time_percent_delta"))
-                        messageScriptValue.setProperty("cursor_time_percent_delta", ((NxCursor*)destination.cursor)->getTimeLocalPercent() - ((NxCursor*)destination.cursor)->getTimeLocalPercentLastSend());
-                    if(patternArgument.contains("cursor_angle_delta"))
-                        messageScriptValue.setProperty("cursor_angle_delta",        ((NxCursor*)destination.cursor)->getCurrentAngle().z() - ((NxCursor*)destination.cursor)->getCurrentAngleLastSend().z());
-
-                    if(patternArgument.contains("cursor_nb_loop"))
-                        messageScriptValue.setProperty("cursor_nb_loop", ((NxCursor*)destination.cursor)->getNbLoop());
-                    if(patternArgument.contains("cursor_message_id"))
-                        messageScriptValue.setProperty("cursor_message_id", (quint32)((NxCursor*)destination.cursor)->getMessageId());
-                }
-                if(((NxCurve*)destination.curve)) {
-                    if(patternArgument.contains("curve_id"))
-                        messageScriptValue.setProperty("curve_id", ((NxCurve*)destination.curve)->getId());
-                    if(patternArgument.contains("curve_group_id"))
-                        messageScriptValue.setProperty("curve_group_id", ((NxCurve*)destination.curve)->getGroupId());
-                    if(patternArgument.contains("curve_label"))
-                        messageScriptValue.setProperty("curve_label", ((NxCurve*)destination.curve)->getLabel());
-                    if(patternArgument.contains("curve_xPos"))
-                        messageScriptValue.setProperty("curve_xPos", ((NxCurve*)destination.curve)->getPos().x());
-                    if(patternArgument.contains("curve_yPos"))
-                        messageScriptValue.setProperty("curve_yPos", ((NxCurve*)destination.curve)->getPos().y());
-                    if(patternArgument.contains("curve_zPos"))
-                        messageScriptValue.setProperty("curve_zPos", ((NxCurve*)destination.curve)->getPos().z());
-                }
-                if(((NxCurve*)destination.collisionCurve)) {
-                    if(patternArgument.contains("collision_curve_id"))
-                        messageScriptValue.setProperty("collision_curve_id", ((NxCurve*)destination.collisionCurve)->getId());
-                    if(patternArgument.contains("collision_curve_group_id"))
-                        messageScriptValue.setProperty("collision_curve_group_id", ((NxCurve*)destination.collisionCurve)->getGroupId());
-                    if(patternArgument.contains("collision_curve_label"))
-                        messageScriptValue.setProperty("collision_curve_label", ((NxCurve*)destination.collisionCurve)->getLabel());
-                    if(patternArgument.contains("collision_curve_xPos"))
-                        messageScriptValue.setProperty("collision_curve_xPos", ((NxCurve*)destination.collisionCurve)->getPos().x());
-                    if(patternArgument.contains("collision_curve_yPos"))
-                        messageScriptValue.setProperty("collision_curve_yPos", ((NxCurve*)destination.collisionCurve)->getPos().y());
-                    if(patternArgument.contains("collision_curve_zPos"))
-                        messageScriptValue.setProperty("collision_curve_zPos", ((NxCurve*)destination.collisionCurve)->getPos().z());
-                    if(patternArgument.contains("collision_xPos"))
-                        messageScriptValue.setProperty("collision_xPos", destination.collisionPoint.x());
-                    if(patternArgument.contains("collision_yPos"))
-                        messageScriptValue.setProperty("collision_yPos", destination.collisionPoint.y());
-                    if(patternArgument.contains("collision_zPos"))
-                        messageScriptValue.setProperty("collision_zPos", destination.collisionPoint.z());
-                    if(patternArgument.contains("collision_value_x"))
-                        messageScriptValue.setProperty("collision_value_x", destination.collisionValue.x());
-                    if(patternArgument.contains("collision_value_y"))
-                        messageScriptValue.setProperty("collision_value_y", destination.collisionValue.y());
-                    if(patternArgument.contains("collision_value_z"))
-                        messageScriptValue.setProperty("collision_value_z", destination.collisionValue.z());
-                    if((patternArgument.contains("collision_distance")) && (((NxCursor*)destination.cursor))) {
-                        NxPoint cursorPosDelta = (((NxCursor*)destination.cursor))?(destination.collisionPoint - ((NxCursor*)destination.cursor)->getCurrentPos()):(NxPoint());
-                        messageScriptValue.setProperty("collision_distance", qSqrt(cursorPosDelta.x()*cursorPosDelta.x() + cursorPosDelta.y()*cursorPosDelta.y() + cursorPosDelta.z()*cursorPosDelta.z()));
-                    }
-                }
-                {
-                    if(patternArgument.contains("status")) {
-                        messageScriptValue.setProperty("status", destination.status.status);
-                        isTransportMessage = true;
-                    }
-                    if(patternArgument.contains("nb_triggers"))
-                        messageScriptValue.setProperty("nb_triggers", destination.status.nbTriggers);
-                    if(patternArgument.contains("nb_cursors"))
-                        messageScriptValue.setProperty("nb_cursors", destination.status.nbCursors);
-                    if(patternArgument.contains("nb_curves"))
-                        messageScriptValue.setProperty("nb_curves", destination.status.nbCurves);
-                    if(patternArgument.contains("global_time"))
-                        messageScriptValue.setProperty("global_time", Transport::timeLocal);
-                    if(patternArgument.contains("global_time_verbose"))
-                        messageScriptValue.setProperty("global_time_verbose", Transport::getTimeLocalStr());
-                }
-
-                messageScriptResult = messageScriptEngine->evaluate(patternArgument);
+                //Compiled once per argument, only the variables it refers to are set
+                const MessageScript &script = getScript(patternArgument);
+                for(quint16 variableIndex = 0 ; variableIndex < script.variables.count() ; variableIndex++)
+                    setScriptVariable(script.variables.at(variableIndex), script.names.at(variableIndex), destination);
+                messageScriptResult = messageScriptEngine->evaluate(script.program);
                 if(messageScriptResult.isError())
-                    addString("**error**", patternArgument, patternIndex);
+                    addString("**error**", script.source, patternIndex);
                 else if(messageScriptResult.isString()) {
                     if(messageScriptResult.toString() == "suppress")
                         suppressSend = true;
                     else
-                        found = addString(messageScriptResult.toString(), QString("script %1").arg(patternIndex), patternIndex);
+                        found = addString(messageScriptResult.toString(), messageArgumentScript, patternIndex);
                 }
                 else
-                    found = addFloat(messageScriptResult.toNumber(), QString("script %1").arg(patternIndex), patternIndex);
+                    found = addFloat(messageScriptResult.toNumber(), messageArgumentScript, patternIndex);
 
 
             }
@@ -557,9 +390,9 @@ bool Message::parse(const QVector<QByteArray> & patternItems, const MessageManag
                     bool ok = false;
                     qreal val = patternArgument.toDouble(&ok);
                     if(ok)
-                        found = addFloat(val, QString("custom %1").arg(patternIndex), patternIndex);
+                        found = addFloat(val, messageArgumentCustom, patternIndex);
                     else
-                        found = addString(patternArgument, QString("custom %1").arg(patternIndex), patternIndex);
+                        found = addString(patternArgument, messageArgumentCustom, patternIndex);
                 }
             }
         }
@@ -573,13 +406,292 @@ bool Message::parse(const QVector<QByteArray> & patternItems, const MessageManag
             buffer += arguments;
         }
         else if((type == MessagesTypeTcp) || (type == MessagesTypeSerial) || (type == MessagesTypeUdp) || (type == MessagesTypeDirect)) {
-            asciiMessage = asciiMessage.trimmed();
+            trim(asciiMessage);
         }
     }
 
     return (hasAdd && !suppressSend);
 }
 
+//Variables available in script arguments
+enum MessageScriptVariable {
+    ScriptTriggerId,
+    ScriptTriggerGroupId,
+    ScriptTriggerLabel,
+    ScriptTriggerXPos,
+    ScriptTriggerYPos,
+    ScriptTriggerZPos,
+    ScriptTriggerValueX,
+    ScriptTriggerValueY,
+    ScriptTriggerValueZ,
+    ScriptTriggerValue,
+    ScriptTriggerDuration,
+    ScriptTriggerDistance,
+    ScriptTriggerSide,
+    ScriptTriggerMessageId,
+    ScriptCursorId,
+    ScriptCursorGroupId,
+    ScriptCursorLabel,
+    ScriptCursorXPos,
+    ScriptCursorYPos,
+    ScriptCursorZPos,
+    ScriptCursorValueX,
+    ScriptCursorValueY,
+    ScriptCursorValueZ,
+    ScriptCursorAPos,
+    ScriptCursorEPos,
+    ScriptCursorDPos,
+    ScriptCursorValueA,
+    ScriptCursorValueE,
+    ScriptCursorValueD,
+    ScriptCursorSxPos,
+    ScriptCursorSyPos,
+    ScriptCursorSzPos,
+    ScriptCursorValueSx,
+    ScriptCursorValueSy,
+    ScriptCursorValueSz,
+    ScriptCursorTime,
+    ScriptCursorTimePercent,
+    ScriptCursorAngle,
+    ScriptCursorXPosDelta,
+    ScriptCursorYPosDelta,
+    ScriptCursorZPosDelta,
+    ScriptCursorValueXDelta,
+    ScriptCursorValueYDelta,
+    ScriptCursorValueZDelta,
+    ScriptCursorAPosDelta,
+    ScriptCursorEPosDelta,
+    ScriptCursorDPosDelta,
+    ScriptCursorValueADelta,
+    ScriptCursorValueEDelta,
+    ScriptCursorValueDDelta,
+    ScriptCursorSxPosDelta,
+    ScriptCursorSyPosDelta,
+    ScriptCursorSzPosDelta,
+    ScriptCursorValueSxDelta,
+    ScriptCursorValueSyDelta,
+    ScriptCursorValueSzDelta,
+    ScriptCursorTimeDelta,
+    ScriptCursorTimePercentDelta,
+    ScriptCursorAngleDelta,
+    ScriptCursorNbLoop,
+    ScriptCursorMessageId,
+    ScriptCurveId,
+    ScriptCurveGroupId,
+    ScriptCurveLabel,
+    ScriptCurveXPos,
+    ScriptCurveYPos,
+    ScriptCurveZPos,
+    ScriptCollisionCurveId,
+    ScriptCollisionCurveGroupId,
+    ScriptCollisionCurveLabel,
+    ScriptCollisionCurveXPos,
+    ScriptCollisionCurveYPos,
+    ScriptCollisionCurveZPos,
+    ScriptCollisionXPos,
+    ScriptCollisionYPos,
+    ScriptCollisionZPos,
+    ScriptCollisionValueX,
+    ScriptCollisionValueY,
+    ScriptCollisionValueZ,
+    ScriptCollisionDistance,
+    ScriptStatus,
+    ScriptNbTriggers,
+    ScriptNbCursors,
+    ScriptNbCurves,
+    ScriptGlobalTime,
+    ScriptGlobalTimeVerbose
+};
+static const char *messageScriptVariables[] = {
+    "trigger_id", "trigger_group_id", "trigger_label", "trigger_xPos", "trigger_yPos", "trigger_zPos",
+    "trigger_value_x", "trigger_value_y", "trigger_value_z", "trigger_value", "trigger_duration",
+    "trigger_distance", "trigger_side", "trigger_message_id", "cursor_id", "cursor_group_id", "cursor_label",
+    "cursor_xPos", "cursor_yPos", "cursor_zPos", "cursor_value_x", "cursor_value_y", "cursor_value_z",
+    "cursor_aPos", "cursor_ePos", "cursor_dPos", "cursor_value_a", "cursor_value_e", "cursor_value_d",
+    "cursor_sxPos", "cursor_syPos", "cursor_szPos", "cursor_value_sx", "cursor_value_sy", "cursor_value_sz",
+    "cursor_time", "cursor_time_percent", "cursor_angle", "cursor_xPos_delta", "cursor_yPos_delta",
+    "cursor_zPos_delta", "cursor_value_x_delta", "cursor_value_y_delta", "cursor_value_z_delta",
+    "cursor_aPos_delta", "cursor_ePos_delta", "cursor_dPos_delta", "cursor_value_a_delta",
+    "cursor_value_e_delta", "cursor_value_d_delta", "cursor_sxPos_delta", "cursor_syPos_delta",
+    "cursor_szPos_delta", "cursor_value_sx_delta", "cursor_value_sy_delta", "cursor_value_sz_delta",
+    "cursor_time_delta", "cursor_time_percent_delta", "cursor_angle_delta", "cursor_nb_loop",
+    "cursor_message_id", "curve_id", "curve_group_id", "curve_label", "curve_xPos", "curve_yPos",
+    "curve_zPos", "collision_curve_id", "collision_curve_group_id", "collision_curve_label",
+    "collision_curve_xPos", "collision_curve_yPos", "collision_curve_zPos", "collision_xPos",
+    "collision_yPos", "collision_zPos", "collision_value_x", "collision_value_y", "collision_value_z",
+    "collision_distance", "status", "nb_triggers", "nb_cursors", "nb_curves", "global_time",
+    "global_time_verbose"
+};
+
+const MessageScript & Message::getScript(const QByteArray &patternArgument) {
+    QHash<QByteArray, MessageScript>::const_iterator scriptIterator = scripts.constFind(patternArgument);
+    if(scriptIterator != scripts.constEnd())
+        return scriptIterator.value();
+
+    //Parsed once, with the list of variables the expression refers to
+    MessageScript script;
+    script.source = patternArgument.trimmed().mid(1);
+    script.source.chop(1);
+    script.program = QScriptProgram(script.source);
+    for(quint8 variable = 0 ; variable <= ScriptGlobalTimeVerbose ; variable++) {
+        if(script.source.contains(messageScriptVariables[variable])) {
+            script.variables.append(variable);
+            script.names.append(messageScriptEngine->toStringHandle(messageScriptVariables[variable]));
+        }
+    }
+    return scripts.insert(patternArgument, script).value();
+}
+void Message::setScriptVariable(quint8 variable, const QScriptString &name, const MessageManagerDestination &destination) {
+    NxTrigger *trigger        = (NxTrigger*)destination.trigger;
+    NxCursor  *cursor         = (NxCursor*)destination.cursor;
+    NxCurve   *curve          = (NxCurve*)destination.curve;
+    NxCurve   *collisionCurve = (NxCurve*)destination.collisionCurve;
+
+    //Variables of absent objects keep their previous value
+    if((variable <= ScriptTriggerMessageId) && (!trigger))
+        return;
+    if((variable >= ScriptCursorId) && (variable <= ScriptCursorMessageId) && (!cursor))
+        return;
+    if((variable >= ScriptCurveId) && (variable <= ScriptCurveZPos) && (!curve))
+        return;
+    if((variable >= ScriptCollisionCurveId) && (variable <= ScriptCollisionDistance) && (!collisionCurve))
+        return;
+
+    QScriptValue value;
+    switch(variable) {
+    //Trigger
+    case ScriptTriggerId:               value = trigger->getId(); break;
+    case ScriptTriggerGroupId:          value = trigger->getGroupId(); break;
+    case ScriptTriggerLabel:            value = trigger->getLabel(); break;
+    case ScriptTriggerXPos:             value = trigger->getPos().x(); break;
+    case ScriptTriggerYPos:             value = trigger->getPos().y(); break;
+    case ScriptTriggerZPos:             value = trigger->getPos().z(); break;
+    case ScriptTriggerValueX:           if(!cursor) return; value = cursor->getCursorValue(trigger->getPos()).x(); break;
+    case ScriptTriggerValueY:           if(!cursor) return; value = cursor->getCursorValue(trigger->getPos()).y(); break;
+    case ScriptTriggerValueZ:           if(!cursor) return; value = cursor->getCursorValue(trigger->getPos()).z(); break;
+    case ScriptTriggerValue:            value = trigger->getTrigged(); break;
+    case ScriptTriggerDuration:         value = trigger->getTriggerOff(); break;
+    case ScriptTriggerMessageId:        value = (quint32)trigger->getMessageId(); break;
+
+    //Cursor
+    case ScriptCursorId:                value = cursor->getId(); break;
+    case ScriptCursorGroupId:           value = cursor->getGroupId(); break;
+    case ScriptCursorLabel:             value = cursor->getLabel(); break;
+    case ScriptCursorXPos:              value = cursor->getCurrentPos().x(); break;
+    case ScriptCursorYPos:              value = cursor->getCurrentPos().y(); break;
+    case ScriptCursorZPos:              value = cursor->getCurrentPos().z(); break;
+    case ScriptCursorValueX:            value = cursor->getCurrentValue().x(); break;
+    case ScriptCursorValueY:            value = cursor->getCurrentValue().y(); break;
+    case ScriptCursorValueZ:            value = cursor->getCurrentValue().z(); break;
+    case ScriptCursorAPos:              value = cursor->getCurrentAed().x(); break;
+    case ScriptCursorEPos:              value = cursor->getCurrentAed().y(); break;
+    case ScriptCursorDPos:              value = cursor->getCurrentAed().z(); break;
+    case ScriptCursorValueA:            value = cursor->getCurrentValueAed().x(); break;
+    case ScriptCursorValueE:            value = cursor->getCurrentValueAed().y(); break;
+    case ScriptCursorValueD:            value = cursor->getCurrentValueAed().z(); break;
+    case ScriptCursorSxPos:             value = cursor->getCurrentPos().sx(); break;
+    case ScriptCursorSyPos:             value = cursor->getCurrentPos().sy(); break;
+    case ScriptCursorSzPos:             value = cursor->getCurrentPos().sz(); break;
+    case ScriptCursorValueSx:           value = cursor->getCurrentValue().sx(); break;
+    case ScriptCursorValueSy:           value = cursor->getCurrentValue().sy(); break;
+    case ScriptCursorValueSz:           value = cursor->getCurrentValue().sz(); break;
+    case ScriptCursorTime:              value = cursor->getTimeLocal(); break;
+    case ScriptCursorTimePercent:       value = cursor->getTimeLocalPercent(); break;
+    case ScriptCursorAngle:             value = fmod(cursor->getCurrentAngle().z(), 360); break;
+    case ScriptCursorXPosDelta:         value = cursor->getCurrentPos().x()    - cursor->getCurrentPosLastSend().x(); break;
+    case ScriptCursorYPosDelta:         value = cursor->getCurrentPos().y()    - cursor->getCurrentPosLastSend().y(); break;
+    case ScriptCursorZPosDelta:         value = cursor->getCurrentPos().z()    - cursor->getCurrentPosLastSend().z(); break;
+    case ScriptCursorValueXDelta:       value = cursor->getCurrentValue().x()  - cursor->getCurrentValueLastSend().x(); break;
+    case ScriptCursorValueYDelta:       value = cursor->getCurrentValue().y()  - cursor->getCurrentValueLastSend().y(); break;
+    case ScriptCursorValueZDelta:       value = cursor->getCurrentValue().z()  - cursor->getCurrentValueLastSend().z(); break;
+    case ScriptCursorAPosDelta:         value = cursor->getCurrentAed().x()    - cursor->getCurrentAedLastSend().x(); break;
+    case ScriptCursorEPosDelta:         value = cursor->getCurrentAed().y()    - cursor->getCurrentAedLastSend().y(); break;
+    case ScriptCursorDPosDelta:         value = cursor->getCurrentAed().z()    - cursor->getCurrentAedLastSend().z(); break;
+    case ScriptCursorValueADelta:       value = cursor->getCurrentValueAed().x()  - cursor->getCurrentValueAedLastSend().x(); break;
+    case ScriptCursorValueEDelta:       value = cursor->getCurrentValueAed().y()  - cursor->getCurrentValueAedLastSend().y(); break;
+    case ScriptCursorValueDDelta:       value = cursor->getCurrentValueAed().z()  - cursor->getCurrentValueAedLastSend().z(); break;
+    case ScriptCursorSxPosDelta:        value = cursor->getCurrentPos().sx()   - cursor->getCurrentPosLastSend().sx(); break;
+    case ScriptCursorSyPosDelta:        value = cursor->getCurrentPos().sy()   - cursor->getCurrentPosLastSend().sy(); break;
+    case ScriptCursorSzPosDelta:        value = cursor->getCurrentPos().sz()   - cursor->getCurrentPosLastSend().sz(); break;
+    case ScriptCursorValueSxDelta:      value = cursor->getCurrentValue().sx() - cursor->getCurrentValueLastSend().sx(); break;
+    case ScriptCursorValueSyDelta:      value = cursor->getCurrentValue().sy() - cursor->getCurrentValueLastSend().sy(); break;
+    case ScriptCursorValueSzDelta:      value = cursor->getCurrentValue().sz() - cursor->getCurrentValueLastSend().sz(); break;
+    case ScriptCursorTimeDelta:         value = cursor->getTimeLocal()        - cursor->getTimeLocalLastSend(); break;
+    case ScriptCursorTimePercentDelta:  value = cursor->getTimeLocalPercent() - cursor->getTimeLocalPercentLastSend(); break;
+    case ScriptCursorAngleDelta:        value = cursor->getCurrentAngle().z() - cursor->getCurrentAngleLastSend().z(); break;
+    case ScriptCursorNbLoop:            value = cursor->getNbLoop(); break;
+    case ScriptCursorMessageId:         value = (quint32)cursor->getMessageId(); break;
+
+    //Curve
+    case ScriptCurveId:                 value = curve->getId(); break;
+    case ScriptCurveGroupId:            value = curve->getGroupId(); break;
+    case ScriptCurveLabel:              value = curve->getLabel(); break;
+    case ScriptCurveXPos:               value = curve->getPos().x(); break;
+    case ScriptCurveYPos:               value = curve->getPos().y(); break;
+    case ScriptCurveZPos:               value = curve->getPos().z(); break;
+
+    //Collision
+    case ScriptCollisionCurveId:        value = collisionCurve->getId(); break;
+    case ScriptCollisionCurveGroupId:   value = collisionCurve->getGroupId(); break;
+    case ScriptCollisionCurveLabel:     value = collisionCurve->getLabel(); break;
+    case ScriptCollisionCurveXPos:      value = collisionCurve->getPos().x(); break;
+    case ScriptCollisionCurveYPos:      value = collisionCurve->getPos().y(); break;
+    case ScriptCollisionCurveZPos:      value = collisionCurve->getPos().z(); break;
+    case ScriptCollisionXPos:           value = destination.collisionPoint.x(); break;
+    case ScriptCollisionYPos:           value = destination.collisionPoint.y(); break;
+    case ScriptCollisionZPos:           value = destination.collisionPoint.z(); break;
+    case ScriptCollisionValueX:         value = destination.collisionValue.x(); break;
+    case ScriptCollisionValueY:         value = destination.collisionValue.y(); break;
+    case ScriptCollisionValueZ:         value = destination.collisionValue.z(); break;
+
+    //Transport
+    case ScriptNbTriggers:              value = destination.status.nbTriggers; break;
+    case ScriptNbCursors:               value = destination.status.nbCursors; break;
+    case ScriptNbCurves:                value = destination.status.nbCurves; break;
+    case ScriptGlobalTime:              value = Transport::timeLocal; break;
+    case ScriptGlobalTimeVerbose:       value = Transport::getTimeLocalStr(); break;
+
+    //Computed values
+    case ScriptTriggerDistance: {
+        if(!cursor)
+            return;
+        NxPoint cursorPosDelta = trigger->getPos() - cursor->getCurrentPos();
+        value = qSqrt(cursorPosDelta.x()*cursorPosDelta.x() + cursorPosDelta.y()*cursorPosDelta.y() + cursorPosDelta.z()*cursorPosDelta.z());
+        break;
+    }
+    case ScriptTriggerSide: {
+        if(!cursor)
+            return;
+        qreal cursorAngle = fmod(cursor->getCurrentAngle().z(), 360);
+        float side = 0;
+        if(cursorAngle == 90) //cursor going straight up
+            side = (trigger->getPos().x() > cursor->getCurrentPos().x()) ? 1:0;
+        else if (cursorAngle == 270) //cursor going straight down
+            side = (trigger->getPos().x() > cursor->getCurrentPos().x()) ? 0:1;
+        else if(((0<cursorAngle) && (cursorAngle<90)) || ((270<cursorAngle) && (cursorAngle<360)) ) //cursor going to left
+            side = (trigger->getPos().y() > cursor->getCurrentPos().y()) ? 1:0;
+        else //cursor going to right
+            side = (trigger->getPos().y() > cursor->getCurrentPos().y()) ? 0:1;
+        value = side;
+        break;
+    }
+    case ScriptCollisionDistance: {
+        if(!cursor)
+            return;
+        NxPoint cursorPosDelta = destination.collisionPoint - cursor->getCurrentPos();
+        value = qSqrt(cursorPosDelta.x()*cursorPosDelta.x() + cursorPosDelta.y()*cursorPosDelta.y() + cursorPosDelta.z()*cursorPosDelta.z());
+        break;
+    }
+    case ScriptStatus:
+        value = destination.status.status;
+        isTransportMessage = true;
+        break;
+    default:
+        return;
+    }
+    messageScriptValue.setProperty(name, value);
+}
+
 const QByteArray Message::getVerboseMessage(bool) const {
     if(type == MessagesTypeHttp)
         return qPrintable(urlMessage.toString());
@@ -591,6 +703,12 @@ const QByteArray Message::getVerboseMessage(bool) const {
     }
 }
 
+const QByteArray Message::getLogHeader() const {
+    if(type == MessagesTypeHttp)
+        return qPrintable(urlMessage.toString());
+    return urlMessageString;
+}
+
 
 qint64 Message::generateTimeTag() const {
     const qint64 january_1_1900 = -2208988800000ll;
@@ -611,9 +729,10 @@ void Message::addInt(int i, const char *name, quint16) {
         typetag += 'i';
 }
 */
-bool Message::addString(QString str, const QString & name, quint16) {
+bool Message::addString(QString str, const QByteArray & name, quint16 index) {
     str = str.replace("_", " ");
-    verboseValues << str;
+    if(verbose)
+        verboseValues << str;
     hasAdd = true;
     if(type == MessagesTypeOsc) {
         arguments += str;
@@ -624,27 +743,32 @@ bool Message::addString(QString str, const QString & name, quint16) {
     }
     else if(type == MessagesTypeHttp) {
 #ifdef QT4
-        urlMessage.addQueryItem(name, str);
+        urlMessage.addQueryItem(argumentName(name, index), str);
 #else
         QUrlQuery urlQuery(urlMessage);
-        urlQuery.addQueryItem(name, str);
+        urlQuery.addQueryItem(argumentName(name, index), str);
         urlMessage.setQuery(urlQuery);
 #endif
         return true;
     }
     else if(type == MessagesTypeTcp) {
-        asciiMessage    = asciiMessage + " " + qPrintable(str);
-        asciiMessageXml = asciiMessageXml + qPrintable("<ARGUMENT TYPE=\"s\" VALUE=\"" + str + "\"/>");
+        asciiMessage    += ' ';
+        asciiMessage    += qPrintable(str);
+        asciiMessageXml += "<ARGUMENT TYPE=\"s\" VALUE=\"";
+        asciiMessageXml += qPrintable(str);
+        asciiMessageXml += "\"/>";
         return true;
     }
     else if((type == MessagesTypeSerial) || (type == MessagesTypeUdp) || (type == MessagesTypeDirect)) {
-        asciiMessage = asciiMessage + " " + qPrintable(str);
+        asciiMessage += ' ';
+        asciiMessage += qPrintable(str);
         return true;
     }
     return true;
 }
-bool Message::addFloat(float f, const QString & name, quint16) {
-    verboseValues << f;
+bool Message::addFloat(float f, const QByteArray & name, quint16 index) {
+    if(verbose)
+        verboseValues << f;
     hasAdd = true;
     if(type == MessagesTypeOsc) {
         union { float f; char ch[4]; } u;
@@ -658,31 +782,36 @@ bool Message::addFloat(float f, const QString & name, quint16) {
     }
     else if(type == MessagesTypeHttp) {
 #ifdef QT4
-        urlMessage.addQueryItem(name, QString::number(f));
+        urlMessage.addQueryItem(argumentName(name, index), QString::number(f));
 #else
         QUrlQuery urlQuery(urlMessage);
-        urlQuery.addQueryItem(name, QString::number(f));
+        urlQuery.addQueryItem(argumentName(name, index), QString::number(f));
         urlMessage.setQuery(urlQuery);
 #endif
         return true;
     }
     else if(type == MessagesTypeTcp) {
-        asciiMessage    = asciiMessage    + " " + QByteArray::number(f);
-        asciiMessageXml = asciiMessageXml + qPrintable("<ARGUMENT TYPE=\"f\" VALUE=\"" + QString::number(f) + "\"/>");
+        asciiMessage    += ' ';
+        appendNumber(asciiMessage, f);
+        asciiMessageXml += "<ARGUMENT TYPE=\"f\" VALUE=\"";
+        appendNumber(asciiMessageXml, f);
+        asciiMessageXml += "\"/>";
         return true;
     }
-    else if(type == MessagesTypeMidi) {
+    else if((type == MessagesTypeMidi) || (type == MessagesTypeArtnet)) {
         midiValues.append(f);
         return true;
     }
     else if((type == MessagesTypeSerial) || (type == MessagesTypeUdp) || (type == MessagesTypeDirect)) {
-        asciiMessage = asciiMessage + " " + QByteArray::number(f);
+        asciiMessage += ' ';
+        appendNumber(asciiMessage, f);
         return true;
     }
     return true;
 }
-bool Message::addTimeTag(qint64 t, const QString & name, quint16) {
-    verboseValues << t;
+bool Message::addTimeTag(qint64 t, const QByteArray & name, quint16 index) {
+    if(verbose)
+        verboseValues << t;
     hasAdd = true;
     if(type == MessagesTypeOsc) {
         union { qint64 t; char ch[8]; } u;
@@ -700,24 +829,28 @@ bool Message::addTimeTag(qint64 t, const QString & name, quint16) {
     }
     else if(type == MessagesTypeHttp) {
 #ifdef QT4
-        urlMessage.addQueryItem(name, QString::number(t));
+        urlMessage.addQueryItem(argumentName(name, index), QString::number(t));
 #else
         QUrlQuery urlQuery(urlMessage);
-        urlQuery.addQueryItem(name, QString::number(t));
+        urlQuery.addQueryItem(argumentName(name, index), QString::number(t));
         urlMessage.setQuery(urlQuery);
 #endif
         return true;
     }
     else if(type == MessagesTypeTcp) {
-        asciiMessage    = asciiMessage    + " " + QByteArray::number(t);
-        asciiMessageXml = asciiMessageXml + qPrintable("<ARGUMENT TYPE=\"t\" VALUE=\"" + QString::number(t) + "\"/>");
+        asciiMessage    += ' ';
+        appendNumber(asciiMessage, t);
+        asciiMessageXml += "<ARGUMENT TYPE=\"t\" VALUE=\"";
+        appendNumber(asciiMessageXml, t);
+        asciiMessageXml += "\"/>";
         return true;
     }
     else if(type == MessagesTypeMidi) {
         return true;
     }
     else if((type == MessagesTypeSerial) || (type == MessagesTypeUdp) || (type == MessagesTypeDirect)) {
-        asciiMessage = asciiMessage + " " + QByteArray::number(t);
+        asciiMessage += ' ';
+        appendNumber(asciiMessage, t);
         return true;
     }
     return true;
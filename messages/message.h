@@ -25,49 +25,94 @@
 #define MESSAGE_H
 
 #include <qmath.h>
+#include <ctype.h>
+#include <QVector>
 #include <QScriptEngine>
+#include <QScriptProgram>
+#include <QScriptString>
 #include <QUdpSocket>
 #include <QTcpSocket>
 #include <QStringList>
 #include "messages/messagemanagerloginterface.h"
 #include "misc/application.h"
 
+class MessageScript {
+public:
+    QByteArray       source;
+    QScriptProgram   program;
+    QVector<quint8>  variables;
+    QVector<QScriptString> names;
+};
+
 class Message : public MessageLog {
 private:
     QByteArray      arguments, typetag, address, buffer;
     QString         midiCommand, midiPort;
-    QUrl            urlMessage;
+    QUrl            urlMessage, urlMessageBase;
     QByteArray      urlMessageString;
     QByteArray      asciiMessage, asciiMessageXml;
 private:
-    bool            hasAdd, isTransportMessage;
+    bool            hasAdd, isTransportMessage, verbose;
     QScriptValue    messageScriptValue, messageScriptResult;
+    QHash<QByteArray, MessageScript> scripts;
 private:
     QHostAddress    host;
     quint16         port;
+    quint16         artnetUniverse, artnetChannel;
     MessagesType    type;
-    QList<qreal>    midiValues;
+    QVector<qreal>  midiValues;
     QScriptEngine  *messageScriptEngine;
 public:
-    QList<QVariant> verboseValues;
+    QVector<QVariant> verboseValues;
+    quint32 cacheRevision;
+    qint32  logId;
 
 public:
     Message();
 public:
     void setUrl(QString url, QScriptEngine *_messageScriptEngine, const QHash<QString, UiString> &aliases);
     void setUrl(const QUrl & url, QScriptEngine *_messageScriptEngine = 0);
-    bool parse(const QVector<QByteArray> & patternItems, const MessageManagerDestination &destination);
+    bool parse(const QVector<QByteArray> & patternItems, const MessageManagerDestination &destination, bool _verbose = true);
     
 private:
-    bool addString(QString str, const QString & name, quint16);
-    bool addFloat(float f, const QString & name, quint16);
-    bool addTimeTag(qint64 t, const QString & name, quint16);
+    bool addString(QString str, const QByteArray & name, quint16);
+    bool addFloat(float f, const QByteArray & name, quint16);
+    bool addTimeTag(qint64 t, const QByteArray & name, quint16);
+    const MessageScript & getScript(const QByteArray &patternArgument);
+    void setScriptVariable(quint8 variable, const QScriptString &name, const MessageManagerDestination &destination);
 private:
     qint64 generateTimeTag() const;
     inline void pad(QByteArray & b) const {
         while (b.size() % 4 != 0)
             b += (char)0;
     }
+    inline QString argumentName(const QByteArray & name, quint16 index) const {
+        if(name.contains('%'))  return QString(name).arg(index);
+        else                    return name;
+    }
+    //Formatting without temporary strings (and always with a dot as decimal separator)
+    inline void appendNumber(QByteArray & b, float f) const {
+        char number[32];
+        qsnprintf(number, sizeof(number), "%g", f);
+        for(char *c = number ; *c ; c++)
+            if(*c == ',')
+                *c = '.';
+        b += number;
+    }
+    inline void appendNumber(QByteArray & b, qint64 t) const {
+        char number[32];
+        qsnprintf(number, sizeof(number), "%lld", (long long)t);
+        b += number;
+    }
+    inline void trim(QByteArray & b) const {
+        while((b.size()) && (isspace((uchar)b.at(b.size()-1))))
+            b.chop(1);
+        int start = 0;
+        while((start < b.size()) && (isspace((uchar)b.at(start))))
+            start++;
+        if(start)
+            b.remove(0, start);
+    }
     
 public:
     inline       MessagesType   getType()            const { return type;               }
@@ -79,20 +124,28 @@ public:
     
     inline const QString &      getMidiCommand()     const { return midiCommand;        }
     inline const QString &      getMidiPort()        const { return midiPort;           }
+    inline       quint16        getArtnetUniverse()  const { return artnetUniverse;     }
+    inline       quint16        getArtnetChannel()   const { return artnetChannel;      }
+    inline const QVector<qreal> & getValues()        const { return midiValues;         }
     inline const QByteArray &   getAddress()         const { return address;            }
     inline const QUrl &         getUrlMessage()      const { return urlMessage;         }
     inline const QByteArray &   getAsciiMessage()    const { return asciiMessage;       }
     inline const QByteArray &   getAsciiMessageXml() const { return asciiMessageXml;    }
 
     const QByteArray getVerboseMessage(bool withDestination=false) const;
+    inline qint32 getLogId() const { return logId; }
+    const QByteArray getLogHeader() const;
+    inline const QVector<QVariant> getLogValues() const { return (type == MessagesTypeHttp) ? QVector<QVariant>() : verboseValues; }
     inline qreal getMidiValue(quint8 index) const {
         if(index < midiValues.count())  return midiValues.at(index);
         else                            return 0;
     }
     inline void setMidiValue(quint8 index, qreal value, const QString &extraInfo = "") {
         if(index < midiValues.count()) {
-            if(extraInfo.isEmpty()) verboseValues[index] = value;
-            else                    verboseValues[index] = QString("%1 (%2)").arg(value).arg(extraInfo);
+            if(index < verboseValues.count()) {
+                if(extraInfo.isEmpty()) verboseValues[index] = value;
+                else                    verboseValues[index] = QString("%1 (%2)").arg(value).arg(extraInfo);
+            }
             midiValues[index]    = value;
         }
     }
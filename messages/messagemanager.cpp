@@ -23,10 +23,13 @@
 
 #include "messagemanager.h"
 #include "objects/nxobject.h"
+#include "misc/benchmark.h"
 
 QList<MessageManagerLogInterface*>      MessageManager::logs;
-Message                                 MessageManager::message;
-QHash<QByteArray, Message>              MessageManager::messagesCache;
+QHash<QByteArray, Message*>             MessageManager::messagesCache;
+quint32                                 MessageManager::messagesCacheRevision = 0;
+quint16                                 MessageManager::messagesCacheUsers    = 0;
+bool                                    MessageManager::messagesCacheStale    = false;
 QHash<MessagesType, NetworkInterface*>  MessageManager::interfaces;
 QHash<QString, UiString>                MessageManager::aliases;
 MessageDispatcher*                      MessageManager::dispatcher        = 0;
@@ -78,10 +81,14 @@ void MessageManager::networkSynchro(bool start) {
 }
 
 void MessageManager::logSend(const MessageLog &message, QStringList *sentMessage) {
+    if((!sentMessage) && (!isLogging()))
+        return;
     foreach(MessageManagerLogInterface *log, logs)
         log->logSend(message, sentMessage);
 }
 void MessageManager::logReceive(const MessageLog &message, QStringList *sentMessage) {
+    if((!sentMessage) && (!isLogging()))
+        return;
     foreach(MessageManagerLogInterface *log, logs)
         log->logReceive(message, sentMessage);
 }
@@ -102,21 +109,38 @@ QString MessageManager::incomingMessage(const MessageIncomming &source, bool nee
 void MessageManager::outgoingMessage(const MessageManagerDestination &destination) {
     if((destination.object) && (Application::current->hasStarted)) {
         QStringList sentMessages;
+        bool hover   = ((NxObject*)destination.object)->getSelectedHover();
+        bool verbose = (hover) || (isLogging());
+        messagesCacheUsers++;
         foreach(const QVector<QByteArray> &messagePattern, ((NxObject*)destination.object)->getMessagePatterns()) {
-            if(messagesCache.contains(messagePattern.at(0)))
-                message = messagesCache.value(messagePattern.at(0));
-            else {
-                message.setUrl(messagePattern.at(0), scriptEngine, aliases);
+            //One encoder per pattern, its buffers are reused from one send to the other
+            Message *message = messagesCache.value(messagePattern.at(0), 0);
+            if(!message) {
+                message = new Message();
                 messagesCache.insert(messagePattern.at(0), message);
             }
-            if(message.parse(messagePattern, destination)) {
-                if(((NxObject*)destination.object)->getSelectedHover())
-                    interfaces[message.getType()]->send(message, &sentMessages);
-                else
-                    interfaces[message.getType()]->send(message);
+            if((message->cacheRevision != messagesCacheRevision) || (message->getUrlMessage().isEmpty())) {
+                message->setUrl(messagePattern.at(0), scriptEngine, aliases);
+                message->cacheRevision = messagesCacheRevision;
+            }
+            int allocations = Benchmark::allocations.fetchAndAddRelaxed(0);
+            if(message->parse(messagePattern, destination, verbose)) {
+                NetworkInterface *networkInterface = interfaces.value(message->getType(), 0);
+                if(networkInterface) {
+                    if(hover)
+                        networkInterface->send(*message, &sentMessages);
+                    else
+                        networkInterface->send(*message);
+                }
+                if(Benchmark::enabled)
+                    Benchmark::addMessage(*message, allocations);
             }
         }
-        if((((NxObject*)destination.object)->getSelectedHover()) && (sentMessages.count()))
+        if((hover) && (sentMessages.count()))
             ((NxObject*)destination.object)->setMessageLabel(sentMessages);
+        if((--messagesCacheUsers == 0) && (messagesCacheStale)) {
+            messagesCacheStale = false;
+            clearMessagesCache();
+        }
     }
 }
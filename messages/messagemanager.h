@@ -25,6 +25,7 @@
 #define MESSAGEMANAGER_H
 
 #include "messages/message.h"
+#include "messages/messagesender.h"
 #include "messagemanagerlog.h"
 #include "messagemanagerlogmini.h"
 
@@ -36,8 +37,10 @@ public:
     static quint16 transportNbTriggers, transportNbCursors, transportNbCurves, transportNbGroups;
     static QList<MessageManagerLogInterface*> logs;
     static MessageDispatcher *dispatcher;
-    static QHash<QByteArray, Message> messagesCache;
-    static Message message;
+    static QHash<QByteArray, Message*> messagesCache;
+    static quint32 messagesCacheRevision;
+    static quint16 messagesCacheUsers;
+    static bool    messagesCacheStale;
     static QHash<MessagesType, NetworkInterface*> interfaces;
     static QHash<QString, UiString> aliases;
     static QScriptEngine *scriptEngine;
@@ -48,6 +51,19 @@ public:
     static void setInterfaces(MessageDispatcher *_dispatcher = 0, QScriptEngine *_scriptEngine = 0, QLayout *logWidget = 0, QLayout *logMiniWidget = 0);
     static void addNetworkInterface(MessagesType type, NetworkInterface *networkInterface);
     static void deleteNetworkInterface();
+    static inline void clearMessagesCache() {
+        //Encoders still used by a send in progress (direct messages) are freed when it returns
+        messagesCacheRevision++;
+        if(messagesCacheUsers)
+            messagesCacheStale = true;
+        else {
+            qDeleteAll(messagesCache);
+            messagesCache.clear();
+        }
+    }
+    static inline bool isLogging() {
+        return ((messageManagerLog) && (messageManagerLog->enable)) || (Application::enableMiniLog);
+    }
     static inline void setLogVisibility(bool logVisible) {
         if(messageManagerLog) messageManagerLog->enable = logVisible;
     }
@@ -23,12 +23,26 @@
 
 #include "messagemanagerlog.h"
 #include "ui_messagemanagerlog.h"
+#include <QScrollBar>
 
 MessageManagerLog::MessageManagerLog(QLayout *layout) :
     QWidget(0),
     ui(new Ui::MessageManagerLog) {
     ui->setupUi(this);
 
+    //Bounded logs, only visible rows are formatted
+    logSendModel    = new MessageManagerLogModel(this);
+    logReceiveModel = new MessageManagerLogModel(this);
+    ui->logSend   ->setModel(logSendModel);
+    ui->logReceive->setModel(logReceiveModel);
+    logSendFollow = logReceiveFollow = true;
+    connect(logSendModel,    SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), SLOT(logAboutToInsert()));
+    connect(logReceiveModel, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), SLOT(logAboutToInsert()));
+    connect(logSendModel,    SIGNAL(rowsInserted(QModelIndex,int,int)),          SLOT(logInserted()));
+    connect(logReceiveModel, SIGNAL(rowsInserted(QModelIndex,int,int)),          SLOT(logInserted()));
+    connect(ui->logSendFilter,    SIGNAL(textChanged(QString)), logSendModel,    SLOT(setFilter(QString)));
+    connect(ui->logReceiveFilter, SIGNAL(textChanged(QString)), logReceiveModel, SLOT(setFilter(QString)));
+
     enable = false;
     if(layout)
         layout->addWidget(this);
@@ -42,16 +56,32 @@ MessageManagerLog::~MessageManagerLog() {
 
 void MessageManagerLog::logSend(const MessageLog &log, QStringList*) {
     if(enable)
-        ui->logSend->appendPlainText(Transport::timeLocalStr + " : " + log.getVerboseMessage());
+        logSendModel->append(log);
 }
 void MessageManagerLog::logReceive(const MessageLog &log, QStringList*) {
     if(enable)
-        ui->logReceive->appendPlainText(Transport::timeLocalStr + " : " + log.getVerboseMessage());
+        logReceiveModel->append(log);
+}
+
+void MessageManagerLog::logAboutToInsert() {
+    //Views only follow new messages when they are already scrolled to the bottom
+    if(sender() == logSendModel)    logSendFollow    = (ui->logSend   ->verticalScrollBar()->value() == ui->logSend   ->verticalScrollBar()->maximum());
+    else                            logReceiveFollow = (ui->logReceive->verticalScrollBar()->value() == ui->logReceive->verticalScrollBar()->maximum());
+}
+void MessageManagerLog::logInserted() {
+    if((sender() == logSendModel) && (logSendFollow))
+        ui->logSend->scrollToBottom();
+    else if((sender() == logReceiveModel) && (logReceiveFollow))
+        ui->logReceive->scrollToBottom();
 }
 
 void MessageManagerLog::action() {
     if(sender() == ui->logSendCopy)
-        QApplication::clipboard()->setText(ui->logSend->toPlainText());
+        QApplication::clipboard()->setText(logSendModel->toPlainText(ui->logSend->selectionModel()->selectedIndexes()));
     else if(sender() == ui->logReceiveCopy)
-        QApplication::clipboard()->setText(ui->logReceive->toPlainText());
+        QApplication::clipboard()->setText(logReceiveModel->toPlainText(ui->logReceive->selectionModel()->selectedIndexes()));
+    else if(sender() == ui->logSendClear)
+        logSendModel->clear();
+    else if(sender() == ui->logReceiveClear)
+        logReceiveModel->clear();
 }
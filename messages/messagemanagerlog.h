@@ -26,6 +26,7 @@
 
 #include <QWidget>
 #include "messagemanagerloginterface.h"
+#include "messagemanagerlogmodel.h"
 
 namespace Ui {
 class MessageManagerLog;
@@ -48,9 +49,14 @@ public:
 
 public slots:
     void action();
+private slots:
+    void logAboutToInsert();
+    void logInserted();
 
 private:
     Ui::MessageManagerLog *ui;
+    MessageManagerLogModel *logSendModel, *logReceiveModel;
+    bool logSendFollow, logReceiveFollow;
 };
 
 #endif // MESSAGEMANAGERLOG_H
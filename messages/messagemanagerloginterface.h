@@ -26,13 +26,14 @@
 
 #include <QObject>
 #include <QVariant>
+#include <QVector>
 #include <QWidget>
 #include "transport/transport.h"
 #include "misc/application.h"
 #include "geometry/nxpoint.h"
 #include "iannix_cmd.h"
 
-enum MessagesType     { MessagesTypeDirect, MessagesTypeOsc, MessagesTypeUdp, MessagesTypeTcp, MessagesTypeSyphon, MessagesTypeHttp, MessagesTypeSerial, MessagesTypeMidi };
+enum MessagesType     { MessagesTypeDirect, MessagesTypeOsc, MessagesTypeUdp, MessagesTypeTcp, MessagesTypeSyphon, MessagesTypeHttp, MessagesTypeSerial, MessagesTypeMidi, MessagesTypeArtnet };
 
 class MessageLog {
 private:
@@ -41,6 +42,9 @@ public:
     explicit MessageLog() { }
     explicit MessageLog(const QString &_message) { message = qPrintable(_message);  }
     virtual const QByteArray getVerboseMessage(bool=false) const { return message; }
+    virtual qint32 getLogId() const { return -1; }
+    virtual const QByteArray getLogHeader() const { return getVerboseMessage(); }
+    virtual const QVector<QVariant> getLogValues() const { return QVector<QVariant>(); }
 };
 
 class MessageManagerLogInterface {
@@ -42,15 +42,19 @@ MessageManagerLogMini::~MessageManagerLogMini() {
 }
 
 void MessageManagerLogMini::logSend(const MessageLog &log, QStringList *sentMessage) {
-    if((canDisplay) && (Application::enableMiniLog)) {
-        QString logged = Transport::timeLocalStr + " : " + log.getVerboseMessage();
-        ui->log->setText(logged.replace("\t", " "));
+    bool display = (canDisplay) && (Application::enableMiniLog);
+    if((!display) && (!sentMessage))
+        return;
+
+    //Format once, only if the label or the hover need it
+    QString logged = Transport::timeLocalStr + " : " + log.getVerboseMessage();
+    logged.replace("\t", " ");
+    if(display) {
+        ui->log->setText(logged);
         canDisplay = false;
     }
-    if(sentMessage) {
-        QString logged = Transport::timeLocalStr + " : " + log.getVerboseMessage();
-        sentMessage->append(logged.replace("\t", " "));
-    }
+    if(sentMessage)
+        sentMessage->append(logged);
 }
 void MessageManagerLogMini::logReceive(const MessageLog &log, QStringList *sentMessage) {
     logSend(log, sentMessage);
@@ -0,0 +1,156 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "messagemanagerlogmodel.h"
+
+MessageManagerLogModel::MessageManagerLogModel(QObject *parent) :
+    QAbstractListModel(parent) {
+    //Fixed ring of events, oldest entries are overwritten
+    events.resize(MESSAGEMANAGERLOG_CAPACITY);
+    eventsFirst = eventsNext = 0;
+    rows.reserve(MESSAGEMANAGERLOG_CAPACITY);
+
+    //Views are refreshed in batches rather than for each message
+    connect(&flushTimer, SIGNAL(timeout()), SLOT(flush()));
+    flushTimer.start(100);
+}
+
+void MessageManagerLogModel::append(const MessageLog &log) {
+    MessageManagerLogEvent &event = events[eventsNext % MESSAGEMANAGERLOG_CAPACITY];
+    //Raw fields are kept, text is only built for displayed rows
+    event.time    = Transport::timeLocal;
+    event.header  = log.getLogHeader();
+    event.values  = log.getLogValues();
+    event.id      = log.getLogId();
+    if(match(event))
+        rowsPending.append(eventsNext);
+    eventsNext++;
+    if((eventsNext - eventsFirst) > MESSAGEMANAGERLOG_CAPACITY)
+        eventsFirst = eventsNext - MESSAGEMANAGERLOG_CAPACITY;
+}
+
+void MessageManagerLogModel::flush() {
+    //Evicted rows
+    int rowsEvicted = 0;
+    while((rowsEvicted < rows.count()) && ((qint32)(rows.at(rowsEvicted) - eventsFirst) < 0))
+        rowsEvicted++;
+    if(rowsEvicted) {
+        beginRemoveRows(QModelIndex(), 0, rowsEvicted - 1);
+        rows.remove(0, rowsEvicted);
+        endRemoveRows();
+    }
+
+    //New rows (pending ones may have been overwritten between two flushes)
+    int pendingIndex = 0;
+    while((pendingIndex < rowsPending.count()) && ((qint32)(rowsPending.at(pendingIndex) - eventsFirst) < 0))
+        pendingIndex++;
+    if(pendingIndex < rowsPending.count()) {
+        beginInsertRows(QModelIndex(), rows.count(), rows.count() + rowsPending.count() - pendingIndex - 1);
+        for(; pendingIndex < rowsPending.count() ; pendingIndex++)
+            rows.append(rowsPending.at(pendingIndex));
+        endInsertRows();
+    }
+    rowsPending.resize(0);
+}
+
+void MessageManagerLogModel::clear() {
+    beginResetModel();
+    eventsFirst = eventsNext;
+    rows.resize(0);
+    rowsPending.resize(0);
+    endResetModel();
+}
+
+void MessageManagerLogModel::setFilter(const QString &filter) {
+    //Tokens must all match: #id for an object ID, otherwise a part of the message (osc://, /trigger…)
+    filterTokens.clear();
+    filterIds.clear();
+    foreach(const QString &token, filter.split(" ", QString::SkipEmptyParts)) {
+        bool ok = false;
+        qint32 id = token.mid(1).toInt(&ok);
+        if((token.startsWith("#")) && (ok)) filterIds    .append(id);
+        else                                filterTokens.append(token.toUtf8());
+    }
+
+    //Rows are only rebuilt from the ring, messages are never formatted here
+    beginResetModel();
+    rows.resize(0);
+    rowsPending.resize(0);
+    for(quint32 sequence = eventsFirst ; sequence != eventsNext ; sequence++)
+        if(match(events.at(sequence % MESSAGEMANAGERLOG_CAPACITY)))
+            rows.append(sequence);
+    endResetModel();
+}
+
+bool MessageManagerLogModel::match(const MessageManagerLogEvent &event) const {
+    foreach(qint32 id, filterIds)
+        if(event.id != id)
+            return false;
+    foreach(const QByteArray &token, filterTokens) {
+        bool found = event.header.contains(token);
+        for(int index = 0 ; (!found) && (index < event.values.count()) ; index++)
+            found = event.values.at(index).toByteArray().contains(token);
+        if(!found)
+            return false;
+    }
+    return true;
+}
+
+const QString MessageManagerLogModel::format(quint32 sequence) const {
+    const MessageManagerLogEvent &event = events.at(sequence % MESSAGEMANAGERLOG_CAPACITY);
+    QByteArray message = event.header;
+    foreach(const QVariant &value, event.values)
+        message += "\t" + value.toByteArray();
+    return Transport::getTimeStr(event.time) + " : " + QString::fromUtf8(message);
+}
+
+const QString MessageManagerLogModel::toPlainText(const QModelIndexList &indexes) const {
+    QStringList retour;
+    if(indexes.count()) {
+        QList<int> indexesRows;
+        foreach(const QModelIndex &index, indexes)
+            if(index.row() < rows.count())
+                indexesRows.append(index.row());
+        qSort(indexesRows);
+        foreach(int row, indexesRows)
+            retour.append(format(rows.at(row)));
+    }
+    else {
+        foreach(quint32 sequence, rows)
+            retour.append(format(sequence));
+    }
+    return retour.join("\n");
+}
+
+int MessageManagerLogModel::rowCount(const QModelIndex &parent) const {
+    if(parent.isValid())
+        return 0;
+    return rows.count();
+}
+
+QVariant MessageManagerLogModel::data(const QModelIndex &index, int role) const {
+    //Only called for visible rows
+    if((role == Qt::DisplayRole) && (index.isValid()) && (index.row() < rows.count()))
+        return format(rows.at(index.row()));
+    return QVariant();
+}
@@ -0,0 +1,75 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MESSAGEMANAGERLOGMODEL_H
+#define MESSAGEMANAGERLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "messagemanagerloginterface.h"
+
+#define MESSAGEMANAGERLOG_CAPACITY 10000
+
+class MessageManagerLogEvent {
+public:
+    qreal             time;
+    QByteArray        header;
+    QVector<QVariant> values;
+    qint32            id;
+public:
+    explicit MessageManagerLogEvent() { time = 0; id = -1; }
+};
+
+class MessageManagerLogModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit MessageManagerLogModel(QObject *parent = 0);
+
+private:
+    QVector<MessageManagerLogEvent> events;
+    quint32 eventsFirst, eventsNext;
+    QVector<quint32> rows, rowsPending;
+    QTimer flushTimer;
+private:
+    QList<QByteArray> filterTokens;
+    QList<qint32>     filterIds;
+    bool match(const MessageManagerLogEvent &event) const;
+    const QString format(quint32 sequence) const;
+
+public:
+    void append(const MessageLog &log);
+    const QString toPlainText(const QModelIndexList &indexes = QModelIndexList()) const;
+public slots:
+    void setFilter(const QString &filter);
+    void clear();
+    void flush();
+
+public:
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+};
+
+#endif // MESSAGEMANAGERLOGMODEL_H
@@ -0,0 +1,133 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "messagesender.h"
+
+QList<MessageSenderStats*> MessageSenderStats::stats;
+UiReal MessageSender::dropPolicy = MessageDropNewest;
+
+MessageSenderStats::MessageSenderStats(const QString &_name) {
+    name = _name;
+    depth = 0;
+    reset();
+    stats.append(this);
+}
+MessageSenderStats::~MessageSenderStats() {
+    stats.removeAll(this);
+}
+const QString MessageSenderStats::getStats() {
+    QString retour;
+    foreach(MessageSenderStats *stat, stats) {
+        retour += QString("%1: %2 queued, %3 sent, %4 dropped, %5 pending (max %6)\n").arg(stat->name).arg(stat->queued).arg(stat->sent.fetchAndAddRelaxed(0)).arg(stat->dropped).arg(stat->depth).arg(stat->depthMax);
+        stat->reset();
+    }
+    return retour.trimmed();
+}
+
+
+MessageSender::MessageSender(const QString &_name, QObject *parent) :
+    QThread(parent), MessageSenderStats(_name) {
+    running.fetchAndStoreOrdered(1);
+    bindPort.fetchAndStoreOrdered(0);
+    bindRequest.fetchAndStoreOrdered(0);
+    bindHandled = 0;
+    start(QThread::HighPriority);
+}
+MessageSender::~MessageSender() {
+    running.fetchAndStoreOrdered(0);
+    queueAvailable.release();
+    wait();
+}
+
+void MessageSender::setPort(quint16 port) {
+    //Ask the sender thread to rebind its socket and wait for it, so the caller's
+    //receiving socket is bound last and keeps getting the incoming datagrams
+    QMutexLocker locker(&bindMutex);
+    if((bindPort.fetchAndAddOrdered(0) == port) && (bindHandled == bindRequest.fetchAndAddOrdered(0)))
+        return;
+    bindPort.fetchAndStoreOrdered(port);
+    int request = bindRequest.fetchAndAddOrdered(1) + 1;
+    queueAvailable.release();
+    while(bindHandled != request)
+        if(!bindDone.wait(&bindMutex, 1000))
+            break;
+}
+
+bool MessageSender::push(const QByteArray &data, const QHostAddress &host, quint16 port, const char *suffix) {
+    MessageQueueItem *item = queue.back();
+
+    //Queue is full, wait at most 1ms for the sender if asked to
+    if((!item) && (dropPolicy == MessageDropWait)) {
+        QElapsedTimer waitTimer;
+        waitTimer.start();
+        while((!item) && (waitTimer.elapsed() < 1)) {
+            QThread::yieldCurrentThread();
+            item = queue.back();
+        }
+    }
+
+    if(item) {
+        item->set(data, host, port, suffix);
+        queue.push();
+        queued++;
+        //Only wake the sender when the queue goes from empty to non-empty
+        if(queue.count() == 1)
+            queueAvailable.release();
+    }
+    else
+        dropped++;
+    setDepth(queue.count());
+    return (item != 0);
+}
+
+void MessageSender::run() {
+    QUdpSocket socket;
+    MessageQueueItem *item;
+    quint16 boundPort = 0;
+    int bindHandledLocal = 0;
+    while(running.fetchAndAddOrdered(0)) {
+        //Messages leave from the interface port, shared with its receiving socket
+        int request = bindRequest.fetchAndAddOrdered(0);
+        if(request != bindHandledLocal) {
+            quint16 port = bindPort.fetchAndAddOrdered(0);
+            if(port != boundPort) {
+                socket.abort();
+                if(!socket.bind(QHostAddress::Any, port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+                    qDebug("[%s] Sender can't bind port %d", qPrintable(name), port);
+                boundPort = port;
+            }
+            bindHandledLocal = request;
+            bindMutex.lock();
+            bindHandled = request;
+            bindDone.wakeAll();
+            bindMutex.unlock();
+        }
+        if(!queueAvailable.tryAcquire(1, 100))
+            continue;
+        while((item = queue.front()) != 0) {
+            socket.writeDatagram(item->data, item->host, item->port);
+            queue.pop();
+            sent.fetchAndAddRelaxed(1);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MESSAGESENDER_H
+#define MESSAGESENDER_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QUdpSocket>
+#include "misc/options.h"
+
+//Single producer (scheduler) / single consumer (sender thread) ring buffer
+//Slots are written in place and never released, so their buffers are reused
+template<typename T, int SIZE> class MessageQueue {
+private:
+    T items[SIZE];
+    QAtomicInt head, tail;
+public:
+    explicit MessageQueue() : head(0), tail(0) { }
+    inline T* back() {
+        int headVal = head.fetchAndAddOrdered(0);
+        if(((headVal + 1) % SIZE) == tail.fetchAndAddOrdered(0))
+            return 0;
+        return &items[headVal];
+    }
+    inline void push() {
+        head.fetchAndStoreOrdered((head.fetchAndAddOrdered(0) + 1) % SIZE);
+    }
+    inline T* front() {
+        int tailVal = tail.fetchAndAddOrdered(0);
+        if(tailVal == head.fetchAndAddOrdered(0))
+            return 0;
+        return &items[tailVal];
+    }
+    inline void pop() {
+        tail.fetchAndStoreOrdered((tail.fetchAndAddOrdered(0) + 1) % SIZE);
+    }
+    inline int count() const {
+        int headVal = const_cast<QAtomicInt&>(head).fetchAndAddOrdered(0);
+        int tailVal = const_cast<QAtomicInt&>(tail).fetchAndAddOrdered(0);
+        return (headVal - tailVal + SIZE) % SIZE;
+    }
+    inline int capacity() const { return SIZE - 1; }
+};
+
+class MessageQueueItem {
+public:
+    QByteArray   data;
+    QHostAddress host;
+    quint16      port;
+public:
+    explicit MessageQueueItem() { port = 0; }
+    inline void set(const QByteArray &_data, const QHostAddress &_host, quint16 _port, const char *suffix = 0) {
+        //Copy into the slot's own buffer instead of sharing the encoder's one
+        if(data.capacity() == 0)
+            data.reserve(512);
+        data.resize(0);
+        data.append(_data);
+        if(suffix)
+            data.append(suffix);
+        host = _host;
+        port = _port;
+    }
+};
+
+enum MessageDropPolicy { MessageDropNewest = 0, MessageDropWait = 1 };
+
+class MessageSenderStats {
+public:
+    static QList<MessageSenderStats*> stats;
+    static const QString getStats();
+public:
+    QString name;
+    quint32 queued, dropped, depth, depthMax;
+    QAtomicInt sent;
+public:
+    explicit MessageSenderStats(const QString &_name);
+    virtual ~MessageSenderStats();
+    inline void reset() {
+        queued = dropped = depthMax = 0;
+        sent.fetchAndStoreRelaxed(0);
+    }
+    inline void setDepth(quint32 _depth) {
+        depth = _depth;
+        depthMax = qMax(depth, depthMax);
+    }
+};
+
+class MessageSender : public QThread, public MessageSenderStats {
+    Q_OBJECT
+
+public:
+    static UiReal dropPolicy;
+
+public:
+    explicit MessageSender(const QString &_name, QObject *parent = 0);
+    ~MessageSender();
+
+private:
+    MessageQueue<MessageQueueItem, 4096> queue;
+    QSemaphore queueAvailable;
+    QAtomicInt running, bindPort, bindRequest;
+    QMutex bindMutex;
+    QWaitCondition bindDone;
+    int bindHandled;
+public:
+    void setPort(quint16 port);
+    bool push(const QByteArray &data, const QHostAddress &host, quint16 port, const char *suffix = 0);
+protected:
+    void run();
+};
+
+#endif // MESSAGESENDER_H
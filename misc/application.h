@@ -73,6 +73,7 @@ public slots:
     virtual void pushSnapshot() = 0;
     virtual quint16 getCount(qint8 objectType = -1) = 0;
     virtual const QString serialize() const = 0;
+    virtual const QString getChangesSince(quint32 since) = 0;
     virtual void readyToStart() = 0;
     virtual QMainWindow* getMainWindow() = 0;
     virtual UiRenderPreview* getRenderPreview() = 0;
@@ -80,6 +81,7 @@ public slots:
     virtual void timerTrig(void *object, bool force = false) = 0;
     virtual QString waitForMessage() = 0;
     virtual void* getObjectById(quint16 id) = 0;
+    virtual void* getGroupById(const QString &groupId) = 0;
     virtual void executeAsScript(const QString &script) = 0;
 };
 
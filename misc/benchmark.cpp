@@ -0,0 +1,105 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+#include <stdlib.h>
+#include <new>
+
+bool            Benchmark::enabled          = false;
+QAtomicInt      Benchmark::allocations;
+quint32         Benchmark::messagesCount    = 0;
+quint32         Benchmark::messagesChecksum = 2166136261u;
+quint32         Benchmark::messagesAllocations = 0;
+QVector<qint64> Benchmark::ticksDuration;
+QElapsedTimer   Benchmark::ticksTimer;
+
+//Allocation counter (debug builds only)
+#ifndef QT_NO_DEBUG
+void* operator new(size_t size) {
+    if(Benchmark::enabled)
+        Benchmark::allocations.fetchAndAddRelaxed(1);
+    void *pointer = malloc((size)?(size):(1));
+    if(!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+void operator delete(void *pointer) throw() {
+    free(pointer);
+}
+#endif
+
+void Benchmark::start() {
+    allocations.fetchAndStoreRelaxed(0);
+    messagesCount       = 0;
+    messagesChecksum    = 2166136261u;
+    messagesAllocations = 0;
+    ticksDuration.clear();
+}
+
+void Benchmark::addMessage(const Message &message, int allocationsBefore) {
+    //Allocations made by the encoding and the sending of this message
+    messagesAllocations += allocations.fetchAndAddRelaxed(0) - allocationsBefore;
+
+    //FNV-1a over what is actually put on the wire
+    const QByteArray *payloads[2] = { &message.getBuffer(), &message.getAsciiMessage() };
+    for(quint8 payloadIndex = 0 ; payloadIndex < 2 ; payloadIndex++) {
+        const char *data = payloads[payloadIndex]->constData();
+        for(qint32 index = 0 ; index < payloads[payloadIndex]->size() ; index++)
+            messagesChecksum = (messagesChecksum ^ (quint8)data[index]) * 16777619u;
+    }
+    messagesCount++;
+}
+
+const QString Benchmark::report(const QString &name) {
+    QVector<qint64> ticksSorted = ticksDuration;
+    qSort(ticksSorted);
+
+    qint64 ticksTotal = 0;
+    foreach(qint64 tickDuration, ticksSorted)
+        ticksTotal += tickDuration;
+    qreal ticksTotalSec = qMax(ticksTotal, (qint64)1) / 1000000000.;
+
+    qreal p50 = 0, p99 = 0;
+    if(ticksSorted.count()) {
+        p50 = ticksSorted.at(qMin(ticksSorted.count()-1, (ticksSorted.count() * 50) / 100)) / 1000.;
+        p99 = ticksSorted.at(qMin(ticksSorted.count()-1, (ticksSorted.count() * 99) / 100)) / 1000.;
+    }
+
+    QString allocationsStr = "n/a", allocationsMessageStr = "n/a";
+    if((allocationsCounted()) && (ticksSorted.count()))
+        allocationsStr = QString::number(allocations.fetchAndAddRelaxed(0) / (qreal)ticksSorted.count(), 'f', 1);
+    if((allocationsCounted()) && (messagesCount))
+        allocationsMessageStr = QString::number(messagesAllocations / (qreal)messagesCount, 'f', 2);
+
+    return QString("%1 | %2 ticks | %3 ticks/s | %4 msgs | %5 msgs/s | %6 allocs/tick | %7 allocs/msg | p50 %8 us | p99 %9 us | checksum %10")
+            .arg(name, -40)
+            .arg(ticksSorted.count())
+            .arg(ticksSorted.count() / ticksTotalSec, 0, 'f', 0)
+            .arg(messagesCount)
+            .arg(messagesCount / ticksTotalSec, 0, 'f', 0)
+            .arg(allocationsStr)
+            .arg(allocationsMessageStr)
+            .arg(p50, 0, 'f', 1)
+            .arg(p99, 0, 'f', 1)
+            .arg(messagesChecksum, 8, 16, QChar('0'));
+}
@@ -0,0 +1,59 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QVector>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include "messages/message.h"
+
+class Benchmark {
+public:
+    static bool enabled;
+    static QAtomicInt allocations;
+    static quint32 messagesCount, messagesChecksum, messagesAllocations;
+    static QVector<qint64> ticksDuration;
+    static QElapsedTimer ticksTimer;
+
+public:
+    static void start();
+    static void addMessage(const Message &message, int allocationsBefore);
+    static const QString report(const QString &name);
+    static inline bool allocationsCounted() {
+#ifndef QT_NO_DEBUG
+        return true;
+#else
+        return false;
+#endif
+    }
+    static inline void tickStart() {
+        ticksTimer.start();
+    }
+    static inline void tickStop() {
+        ticksDuration.append(ticksTimer.nsecsElapsed());
+    }
+};
+
+#endif // BENCHMARK_H
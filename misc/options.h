@@ -71,9 +71,10 @@ public:
     NxRect    mapping;
     QSizeF    originalSize;
 public:
-    explicit UiRenderTexture() { loaded = false; }
+    explicit UiRenderTexture() { loaded = false; texture = 0; }
     explicit UiRenderTexture(const QString & _name, const QFileInfo & _filename, const NxRect & _mapping) {
         loaded   = false;
+        texture  = 0;
         isSyphon = false;
         name     = _name;
         filename = _filename;
@@ -185,23 +185,11 @@ void NxCursor::calculate() {
     //Cursor line
     if((curve) && (curve->getPathLength() > 0)) {
         qreal timeReal = easing.getValue(time), timeOldReal = easing.getValue(timeOld);
-        cursorPos = curve->getPointAt(timeReal) + curve->getPos();
-
-        if(timeReal == 0)
-            cursorAngle = -curve->getAngleAt(timeReal + 0.001);
-        else if(timeReal == 1)
-            cursorAngle = -curve->getAngleAt(timeReal - 0.001);
-        else
-            cursorAngle = -curve->getAngleAt(timeReal);
-
-        cursorPosOld = curve->getPointAt(timeOldReal) + curve->getPos();
-
-        if(timeOldReal == 0)
-            cursorAngleOld = -curve->getAngleAt(timeOldReal + 0.001);
-        else if(timeOldReal == 1)
-            cursorAngleOld = -curve->getAngleAt(timeOldReal - 0.001);
-        else
-            cursorAngleOld = -curve->getAngleAt(timeOldReal);
+        //Position and heading from a single evaluation of the curve
+        cursorPos      = curve->getPointAndAngleAt(timeReal, &cursorAngle) + curve->getPos();
+        cursorAngle    = -cursorAngle;
+        cursorPosOld   = curve->getPointAndAngleAt(timeOldReal, &cursorAngleOld) + curve->getPos();
+        cursorAngleOld = -cursorAngleOld;
 
         //Infos en +
         //NxPoint cursorPosDelta = cursorPosOld - cursorPos;
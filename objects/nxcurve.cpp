@@ -37,12 +37,14 @@ NxCurve::NxCurve(ApplicationCurrent *parent, QTreeWidgetItem *ccParentItem) :
     selectedPathPointPoint = selectedPathPointControl1 = selectedPathPointControl2 = -1;
     curveType = CurveTypePoints;
     equationIsValid = false;
+    equationIsDerivable = true;
     glListRecreateFromEditor = false;
     curveNeedUpdate = true;
     equationNbEval = 3;
     pathLength = 0;
     pathPointsEditor = 0;
     shapeSize = NxSize(1, 1, 1);
+    invalidatePathSamples();
     initializeCustom();
 }
 void NxCurve::initializeCustom() {
@@ -67,6 +69,7 @@ NxCurve::~NxCurve() {
 
 void NxCurve::setEquation(const QString &type, const QString &_equation) {
     equation = _equation;
+    equationIsDerivable = true;
     if(type.trimmed().toLower() == "polar")
         curveType = CurveTypeEquationPolar;
     else
@@ -89,6 +92,7 @@ void NxCurve::setEquation(const QString &type, const QString &_equation) {
         equationParser.DefineVar(MUSTR("t"), &equationVariableT);
         equationParser.SetExpr(MUSTR(equation));
         curveNeedUpdate = true;
+        invalidatePathSamples();
         //calcEquation();
         //calcBoundingRect();
     }
@@ -100,6 +104,7 @@ void NxCurve::setEquationPoints(quint16 nbPoints) {
     equationNbPoints = nbPoints;
     equationVariableTSteps = 1. / equationNbPoints;
     curveNeedUpdate = true;
+    invalidatePathSamples();
     //calcEquation();
     //calcBoundingRect();
 }
@@ -117,6 +122,7 @@ void NxCurve::setEquationParam(const QString &param, qreal value) {
     else
         equationVariables[param] = value;
     curveNeedUpdate = true;
+    invalidatePathSamples();
     //calcEquation();
     //calcBoundingRect();
 }
@@ -426,7 +432,29 @@ const NxPoint & NxCurve::setPointAt(quint16 index, const NxPoint & point, bool s
 }
 const NxPoint & NxCurve::setPointAt(quint16 index, const NxPoint & point, const NxPoint & c1, const NxPoint & c2, bool smooth, bool boundingRectCalculation, bool fromGui) {
     glListRecreate = true;
+    bool hasCreate = storePointAt(index, point, c1, c2, smooth);
+
+    if(fromGui) {
+        if(pathPoints[index].smooth)
+            Application::current->execute(QString("%1 %2 %3 %4 %5 %6").arg(COMMAND_CURVE_POINT_SMOOTH).arg(id).arg(index).arg(point.x()).arg(point.y()).arg(point.z()), ExecuteSourceInformative);
+        else if((pathPoints[index].c1 == NxPoint()) && (pathPoints[index].c2 == NxPoint()))
+            Application::current->execute(QString("%1 %2 %3 %4 %5 %6").arg(COMMAND_CURVE_POINT).arg(id).arg(index).arg(point.x()).arg(point.y()).arg(point.z()), ExecuteSourceInformative);
+        else
+            Application::current->execute(QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12").arg(COMMAND_CURVE_POINT).arg(id).arg(index).arg(point.x()).arg(point.y()).arg(point.z()).arg(c1.x()).arg(c1.y()).arg(c1.z()).arg(c2.x()).arg(c2.y()).arg(c2.z()), ExecuteSourceInformative);
+    }
+
+    computeInertie();
+    computeSmooth();
+
+    //Length
+    if((boundingRectCalculation) && ((hasCreate) || (cursors.count() > 0)))
+        curveNeedUpdate = true;
+
+    return point;
+}
+bool NxCurve::storePointAt(quint16 index, const NxPoint & point, const NxPoint & c1, const NxPoint & c2, bool smooth) {
     bool hasCreate = false;
+    invalidatePathSamples();
     if(index >= pathPoints.count()) {
         NxCurvePoint pointStruct;
         pointStruct.setX(point.x());
@@ -466,18 +494,9 @@ const NxPoint & NxCurve::setPointAt(quint16 index, const NxPoint & point, const
             pathPoints[index].smooth = smooth;
         }
     }
-
-    if(fromGui) {
-        if(pathPoints[index].smooth)
-            Application::current->execute(QString("%1 %2 %3 %4 %5 %6").arg(COMMAND_CURVE_POINT_SMOOTH).arg(id).arg(index).arg(point.x()).arg(point.y()).arg(point.z()), ExecuteSourceInformative);
-        else if((pathPoints[index].c1 == NxPoint()) && (pathPoints[index].c2 == NxPoint()))
-            Application::current->execute(QString("%1 %2 %3 %4 %5 %6").arg(COMMAND_CURVE_POINT).arg(id).arg(index).arg(point.x()).arg(point.y()).arg(point.z()), ExecuteSourceInformative);
-        else
-            Application::current->execute(QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12").arg(COMMAND_CURVE_POINT).arg(id).arg(index).arg(point.x()).arg(point.y()).arg(point.z()).arg(c1.x()).arg(c1.y()).arg(c1.z()).arg(c2.x()).arg(c2.y()).arg(c2.z()), ExecuteSourceInformative);
-    }
-
-    computeInertie();
-
+    return hasCreate;
+}
+void NxCurve::computeSmooth() {
     bool isLoop = false;
     if((pathPoints.count() > 0) && ((NxPoint)getPathPointsAt(0) == (NxPoint)getPathPointsAt(pathPoints.count()-1)))
         isLoop = true;
@@ -512,13 +531,6 @@ const NxPoint & NxCurve::setPointAt(quint16 index, const NxPoint & point, const
             }
         }
     }
-
-
-    //Length
-    if((boundingRectCalculation) && ((hasCreate) || (cursors.count() > 0)))
-        curveNeedUpdate = true;
-
-    return point;
 }
 
 void NxCurve::computeInertie() {
@@ -526,6 +538,7 @@ void NxCurve::computeInertie() {
         for(quint16 index = 0 ; index < pathPoints.count() ; index++) {
             while(pathPointsDest.count() <= index)
                 pathPointsDest.append(pathPoints.at(index));
+            NxCurvePoint pointPrevious = pathPoints.at(index);
             pathPoints[index].setX (pathPoints.at(index).x()  + (pathPointsDest.at(index).x()  - pathPoints.at(index).x())  / inertie);
             pathPoints[index].setY (pathPoints.at(index).y()  + (pathPointsDest.at(index).y()  - pathPoints.at(index).y())  / inertie);
             pathPoints[index].setZ (pathPoints.at(index).z()  + (pathPointsDest.at(index).z()  - pathPoints.at(index).z())  / inertie);
@@ -534,6 +547,8 @@ void NxCurve::computeInertie() {
             pathPoints[index].setSz(pathPoints.at(index).sz() + (pathPointsDest.at(index).sz() - pathPoints.at(index).sz()) / inertie);
             pathPoints[index].c1 = (pathPoints.at(index).c1   + (pathPointsDest.at(index).c1   - pathPoints.at(index).c1)   / inertie);
             pathPoints[index].c2 = (pathPoints.at(index).c2   + (pathPointsDest.at(index).c2   - pathPoints.at(index).c2)   / inertie);
+            if(((NxPoint)pointPrevious != (NxPoint)pathPoints.at(index)) || (pointPrevious.c1 != pathPoints.at(index).c1) || (pointPrevious.c2 != pathPoints.at(index).c2))
+                invalidatePathSamples();
         }
         glListRecreate = true;
     }
@@ -556,33 +571,30 @@ void NxCurve::setSVG2(const QString & polylineData) {
     foreach(const QString & token, tokens) {
         QStringList tokenParams = token.split(",", QString::SkipEmptyParts);
         if(tokenParams.count() == 2)
-            setPointAt(index++, NxPoint(tokenParams.at(0).toDouble(), tokenParams.at(1).toDouble()), NxPoint(), NxPoint(), false);
+            storePointAt(index++, NxPoint(tokenParams.at(0).toDouble(), tokenParams.at(1).toDouble()), NxPoint(), NxPoint(), false);
     }
+    computeInertie();
+    computeSmooth();
 
-    //Scale
-    resize(1, 1);
+    //Calculations
+    glListRecreate = true;
+    curveNeedUpdate = true;
 }
 
 void NxCurve::setImage(const QString & filename) {
     curveType = CurveTypePoints;
 
-    //Load image
-    QFileInfo file(filename);
-    QPixmap pixmap(filename);
-
-    //Create mask
-    QBitmap bitmap(pixmap.createHeuristicMask());
-
-    //Create path
-    pathPoints.clear();
-    QPainterPath pathTmp = QPainterPath();
-    pathTmp.addRegion(QRegion(bitmap));
-
-    //Simplify path
-    setPath(pathTmp.simplified());
-
-    //Scale
-    resize(1, 1);
+    //Contours are traced and simplified on a worker thread
+    NxCurveVectorizer *vectorizer = new NxCurveVectorizer(filename);
+    connect(vectorizer, SIGNAL(finished()), SLOT(setImageFinished()));
+    vectorizer->start(QThread::LowPriority);
+}
+void NxCurve::setImageFinished() {
+    NxCurveVectorizer *vectorizer = qobject_cast<NxCurveVectorizer*>(sender());
+    if((vectorizer) && (!vectorizer->path.isEmpty())) {
+        setPath(vectorizer->path, true);
+        calcBoundingRect();
+    }
 }
 void NxCurve::setEllipse(const NxSize & size) {
     curveType = CurveTypeEllipse;
@@ -614,20 +626,24 @@ void NxCurve::setText(const QString & text, const QString & family) {
     setPath(pathTmp);
 }
 
-void NxCurve::setPath(const QPainterPath &path) {
+void NxCurve::setPath(const QPainterPath &path, bool fromGui) {
+    //Points are stored in one pass (already flipped vertically), smoothing and inertia are computed once
+    curveType = CurveTypePoints;
     pathPoints.clear();
+    pathPointsDest.clear();
+    pathPoints.reserve(path.elementCount());
     quint16 index = 0;
     for(quint16 elementIndex = 0 ; elementIndex < path.elementCount() ; elementIndex++) {
         const QPainterPath::Element &e = path.elementAt(elementIndex);
         switch (e.type) {
         case QPainterPath::MoveToElement:
         {
-            setPointAt(index++, NxPoint(e.x, e.y), NxPoint(), NxPoint(), false);
+            storePointAt(index++, NxPoint(e.x, -e.y), NxPoint(), NxPoint(), false);
             break;
         }
         case QPainterPath::LineToElement:
         {
-            setPointAt(index++, NxPoint(e.x, e.y), NxPoint(), NxPoint(), false);
+            storePointAt(index++, NxPoint(e.x, -e.y), NxPoint(), NxPoint(), false);
             break;
         }
         case QPainterPath::CurveToElement:
@@ -636,7 +652,7 @@ void NxCurve::setPath(const QPainterPath &path) {
             const QPainterPath::Element &c1 = e;
             const QPainterPath::Element &c2 = path.elementAt(elementIndex+1);
             const QPainterPath::Element &p2 = path.elementAt(elementIndex+2);
-            setPointAt(index++, NxPoint(p2.x, p2.y), NxPoint(c1.x - p1.x, c1.y - p1.y), NxPoint(c2.x - p2.x, c2.y - p2.y), false);
+            storePointAt(index++, NxPoint(p2.x, -p2.y), NxPoint(c1.x - p1.x, -(c1.y - p1.y)), NxPoint(c2.x - p2.x, -(c2.y - p2.y)), false);
             elementIndex += 2;
             break;
         }
@@ -644,9 +660,26 @@ void NxCurve::setPath(const QPainterPath &path) {
             break;
         }
     }
+    computeInertie();
+    computeSmooth();
+
+    //Paths set outside of commands are reported as a single SVG path command
+    if(fromGui) {
+        QString pathData;
+        pathData.reserve(path.elementCount() * 24);
+        for(quint16 elementIndex = 0 ; elementIndex < path.elementCount() ; elementIndex++) {
+            const QPainterPath::Element &e = path.elementAt(elementIndex);
+            if(e.type == QPainterPath::MoveToElement)       pathData += "M";
+            else if(e.type == QPainterPath::LineToElement)  pathData += "L";
+            else if(e.type == QPainterPath::CurveToElement) pathData += "C";
+            pathData += QString::number(e.x) + " " + QString::number(e.y) + " ";
+        }
+        Application::current->execute(QString("%1 %2 1 %3").arg(COMMAND_CURVE_PATH).arg(id).arg(pathData.trimmed()), ExecuteSourceInformative);
+    }
 
     //Calculations
-    resize(1, -1);
+    glListRecreate = true;
+    curveNeedUpdate = true;
 }
 
 void NxCurve::resize(qreal sizeFactorW, qreal sizeFactorH) {
@@ -658,6 +691,13 @@ void NxCurve::resize(qreal sizeFactorW, qreal sizeFactorH) {
     else if((equationIsValid) && (!equation.isEmpty()) && ((curveType == CurveTypeEquationCartesian) || (curveType == CurveTypeEquationPolar)))  {
         //IMPOSSIBLE FOR NOW
     }
+    else if((curveType == CurveTypePoints) && ((inertie == 1) || (inertie <= 0))) {
+        //Without inertia, smoothing only depends on the final positions
+        for(quint16 indexPoint = 0 ; indexPoint < pathPoints.count() ; indexPoint++)
+            storePointAt(indexPoint, NxPoint(getPathPointsAt(indexPoint).x() * sizeFactor.width(), getPathPointsAt(indexPoint).y() * sizeFactor.height()), NxPoint(getPathPointsAt(indexPoint).c1.x() * sizeFactor.width(), getPathPointsAt(indexPoint).c1.y() * sizeFactor.height()), NxPoint(getPathPointsAt(indexPoint).c2.x() * sizeFactor.width(), getPathPointsAt(indexPoint).c2.y() * sizeFactor.height()), getPathPointsAt(indexPoint).smooth);
+        computeSmooth();
+        glListRecreate = true;
+    }
     else if(curveType == CurveTypePoints) {
         for(quint16 indexPoint = 0 ; indexPoint < pathPoints.count() ; indexPoint++)
             setPointAt(indexPoint, NxPoint(getPathPointsAt(indexPoint).x() * sizeFactor.width(), getPathPointsAt(indexPoint).y() * sizeFactor.height()), NxPoint(getPathPointsAt(indexPoint).c1.x() * sizeFactor.width(), getPathPointsAt(indexPoint).c1.y() * sizeFactor.height()), NxPoint(getPathPointsAt(indexPoint).c2.x() * sizeFactor.width(), getPathPointsAt(indexPoint).c2.y() * sizeFactor.height()), getPathPointsAt(indexPoint).smooth, false);
@@ -706,6 +746,40 @@ inline NxPoint NxCurve::getPointAt(quint16 index, qreal t) {
     }
 }
 
+inline NxPoint NxCurve::getTangentAt(quint16 index, qreal t) {
+    NxPoint p1 = getPathPointsAt(index), p2 = getPathPointsAt(index+1);
+    NxPoint c1 = getPathPointsAt(index+1).c1, c2 = getPathPointsAt(index+1).c2;
+    if((c1 == NxPoint()) && (c2 == NxPoint()))
+        return NxPoint(p2.x() - p1.x(), p2.y() - p1.y(), p2.z() - p1.z());
+    else {
+        //Derivative of the cubic Bézier
+        NxPoint p1c = p1 + c1, p2c = p2 + c2;
+        qreal mt = 1 - t, a = 3*mt*mt, b = 6*mt*t, c = 3*t*t;
+        return NxPoint( (p1c.x() - p1.x())*a + (p2c.x() - p1c.x())*b + (p2.x() - p2c.x())*c,
+                        (p1c.y() - p1.y())*a + (p2c.y() - p1c.y())*b + (p2.y() - p2c.y())*c,
+                        (p1c.z() - p1.z())*a + (p2c.z() - p1c.z())*b + (p2.z() - p2c.z())*c);
+    }
+}
+
+quint16 NxCurve::getPathPointsIndexAt(qreal val, bool absoluteTime, qreal *t) {
+    qreal length = 0, lengthOld = 0;
+    qreal lengthTarget = (absoluteTime)?(val):(pathLength * val);
+    quint16 index = 0;
+    for(quint16 indexPoint = 1 ; indexPoint < pathPoints.count() ; indexPoint++) {
+        length = getPathPointsAt(indexPoint).currentLength;
+        if(length >= lengthTarget) {
+            index = indexPoint - 1;
+            break;
+        }
+        lengthOld = length;
+    }
+    if((length - lengthOld) != 0)
+        *t = (lengthTarget - lengthOld) / (length - lengthOld);
+    else
+        *t = 0;
+    return index;
+}
+
 NxPoint NxCurve::getPointAt(qreal val, bool absoluteTime) {
     if(curveType == CurveTypeEllipse) {
         qreal angle = 2 * val * M_PI;
@@ -724,62 +798,141 @@ NxPoint NxCurve::getPointAt(qreal val, bool absoluteTime) {
         return NxPoint();
     }
     else if(curveType == CurveTypePoints) {
-        qreal length = 0, lengthOld = 0;
-        qreal lengthTarget = (absoluteTime)?(val):(pathLength * val);
-        quint16 index = 0;
-        for(quint16 indexPoint = 1 ; indexPoint < pathPoints.count() ; indexPoint++) {
-            length = getPathPointsAt(indexPoint).currentLength;
-            if(length >= lengthTarget) {
-                index = indexPoint - 1;
-                break;
-            }
-            lengthOld = length;
-        }
-        if((length - lengthOld) != 0)
-            return getPointAt(index, (lengthTarget - lengthOld) / (length - lengthOld));
-        else
-            return getPointAt(index, 0);
+        qreal t = 0;
+        quint16 index = getPathPointsIndexAt(val, absoluteTime, &t);
+        return getPointAt(index, t);
     }
     return NxPoint();
 }
-NxPoint NxCurve::getAngleAt(qreal val, bool absoluteTime) {
-    qreal angleX = 0, angleY = 0, angleZ = 0;
-    if(curveType == CurveTypeEllipse)
-        angleZ = -((2 * val * M_PI) + M_PI_2) * 180.0F / M_PI;
-    else if((equationIsValid) && (!equation.isEmpty()) && ((curveType == CurveTypeEquationCartesian) || (curveType == CurveTypeEquationPolar)))  {
+NxPoint NxCurve::getPointAndAngleAt(qreal val, NxPoint *angle, bool absoluteTime) {
+    *angle = NxPoint();
+    if(curveType == CurveTypeEllipse) {
+        qreal angleEllipse = 2 * val * M_PI;
+        *angle = NxPoint(0, 0, -(angleEllipse + M_PI_2) * 180.0F / M_PI);
+        return NxPoint(boundingRect.width() * qCos(angleEllipse) / 2, boundingRect.height() * qSin(angleEllipse) / 2, 0);
+    }
+
+    //Cursors on a stable curve read its sample table
+    NxPoint point, delta;
+    if((!absoluteTime) && (getPathSampleAt(val, &point, &delta))) {
+        *angle = getAngleFromDelta(delta);
+        return point;
+    }
+    if(getPointAndDeltaAt(val, &point, &delta, 0, absoluteTime))
+        *angle = getAngleFromDelta(delta);
+    return point;
+}
+bool NxCurve::getPointAndDeltaAt(qreal val, NxPoint *point, NxPoint *delta, quint16 *segment, bool absoluteTime) {
+    *point = NxPoint();
+    if((equationIsValid) && (!equation.isEmpty()) && ((curveType == CurveTypeEquationCartesian) || (curveType == CurveTypeEquationPolar)))  {
+        if(segment)
+            *segment = 0;
+        equationVariableT = val;
         try {
-            NxPoint pt1, pt2;
-            qreal *ptCoords;
-
-            equationVariableT = val;
-            ptCoords = equationParser.Eval(equationNbEval);
-            if(curveType == CurveTypeEquationPolar) pt1 = NxPoint(ptCoords[0] * sin(ptCoords[1] * cos(ptCoords[2])), ptCoords[0] * cos(ptCoords[1]), ptCoords[0] * sin(ptCoords[1]) * sin(ptCoords[2]));
-            else                                    pt1 = NxPoint(ptCoords[0], ptCoords[1], ptCoords[2]);
-
-            equationVariableT = val - 0.001;
-            ptCoords = equationParser.Eval(equationNbEval);
-            if(curveType == CurveTypeEquationPolar) pt2 = NxPoint(ptCoords[0] * sin(ptCoords[1] * cos(ptCoords[2])), ptCoords[0] * cos(ptCoords[1]), ptCoords[0] * sin(ptCoords[1]) * sin(ptCoords[2]));
-            else                                    pt2 = NxPoint(ptCoords[0], ptCoords[1], ptCoords[2]);
-
-            NxPoint deltaPos = pt2 - pt1;
-            angleZ = qAtan2(deltaPos.x(), deltaPos.y()) * 180.0F / M_PI + 90;
-            angleY = qAtan2(qSqrt(deltaPos.x()*deltaPos.x() + deltaPos.y()*deltaPos.y()), deltaPos.z()) * 180.0F / M_PI + 90 + 180;
+            //Position and derivative in one pass (expressions without a derivative fall back to finite differences)
+            qreal *ptDerivatives = 0;
+            qreal *ptCoords = (equationIsDerivable)?(equationParser.EvalDerivative(&equationVariableT, &ptDerivatives, equationNbEval)):(0);
+            if(!ptCoords) {
+                equationIsDerivable = false;
+                *point = getPointAt(val, absoluteTime);
+                *delta = getDeltaAtFinite(val, *point, absoluteTime);
+                return true;
+            }
+
+            NxPoint tangent;
+            if(curveType == CurveTypeEquationPolar) {
+                qreal r = ptCoords[0], sinT = sin(ptCoords[1]), cosT = cos(ptCoords[1]), sinP = sin(ptCoords[2]), cosP = cos(ptCoords[2]);
+                qreal dr = ptDerivatives[0], dT = ptDerivatives[1], dP = ptDerivatives[2];
+                *point  = NxPoint(r * sinT * cosP, r * cosT, r * sinT * sinP);
+                tangent = NxPoint(dr * sinT * cosP + r * cosT * cosP * dT - r * sinT * sinP * dP,
+                                  dr * cosT        - r * sinT * dT,
+                                  dr * sinT * sinP + r * cosT * sinP * dT + r * sinT * cosP * dP);
+            }
+            else {
+                *point  = NxPoint(ptCoords[0], ptCoords[1], ptCoords[2]);
+                tangent = NxPoint(ptDerivatives[0], ptDerivatives[1], ptDerivatives[2]);
+            }
+            if((tangent == NxPoint()) || (tangent != tangent))
+                *delta = getDeltaAtFinite(val, *point, absoluteTime);
+            else
+                *delta = -tangent;
+            return true;
         }
         catch (Parser::exception_type &e) {
             qDebug("[MathParser] AngleAt error");
         }
     }
     else if(curveType == CurveTypePoints) {
-        NxPoint p2 = getPointAt(val - 0.001, absoluteTime), p1 = getPointAt(val, absoluteTime);
-        NxPoint deltaPos = p2 - p1;
-        angleZ = qAtan2(deltaPos.x(), deltaPos.y()) * 180.0F / M_PI + 90;
-        angleY = qAtan2(qSqrt(deltaPos.x()*deltaPos.x() + deltaPos.y()*deltaPos.y()), deltaPos.z()) * 180.0F / M_PI + 90 + 180;
+        qreal t = 0;
+        quint16 index = getPathPointsIndexAt(val, absoluteTime, &t);
+        NxPoint tangent = getTangentAt(index, t);
+        *point = getPointAt(index, t);
+        if(segment)
+            *segment = index;
+        //Bézier handles merged with their point have no tangent at the ends
+        if(tangent == NxPoint())
+            *delta = getDeltaAtFinite(val, *point, absoluteTime);
+        else
+            *delta = -tangent;
+        return true;
+    }
+    return false;
+}
+NxPoint NxCurve::getDeltaAtFinite(qreal val, const NxPoint &point, bool absoluteTime) {
+    if(val >= 0.001)    return getPointAt(val - 0.001, absoluteTime) - point;
+    else                return point - getPointAt(val + 0.001, absoluteTime);
+}
+
+void NxCurve::calcPathSamples() {
+    pathSamplesValid = true;
+    pathSamples.clear();
+
+    //Uniform in the cursor parameter, which follows the path length of point curves
+    quint16 samplesCount = getPathSamplesCount();
+    if(samplesCount < 2)
+        return;
+    pathSamples.resize(samplesCount);
+    for(quint16 indexSample = 0 ; indexSample < samplesCount ; indexSample++) {
+        NxCurveSample &sample = pathSamples[indexSample];
+        if(!getPointAndDeltaAt((qreal)indexSample / (qreal)(samplesCount - 1), &sample.point, &sample.delta, &sample.segment, false)) {
+            pathSamples.clear();
+            return;
+        }
+        qreal deltaLength = qSqrt(sample.delta.x()*sample.delta.x() + sample.delta.y()*sample.delta.y() + sample.delta.z()*sample.delta.z());
+        if(deltaLength > 0)
+            sample.delta /= deltaLength;
+    }
+}
+bool NxCurve::getPathSampleAt(qreal val, NxPoint *point, NxPoint *delta) {
+    if((curveNeedUpdate) || (val < 0) || (val > 1))
+        return false;
+
+    //Built once the curve has been read enough times without changing
+    if(!pathSamplesValid) {
+        if(++pathSamplesLookups < getPathSamplesCount() / 8)
+            return false;
+        calcPathSamples();
     }
-    return NxPoint(angleX, angleY, angleZ);
+    if(pathSamples.isEmpty())
+        return false;
+
+    qreal position = val * (pathSamples.count() - 1);
+    quint16 index  = qMin((quint16)position, (quint16)(pathSamples.count() - 2));
+    const NxCurveSample &sample1 = pathSamples.at(index), &sample2 = pathSamples.at(index+1);
+
+    //Corners between two segments are evaluated exactly
+    if(sample1.segment != sample2.segment)
+        return false;
+
+    qreal t = position - index;
+    *point = sample1.point + (sample2.point - sample1.point) * t;
+    *delta = sample1.delta + (sample2.delta - sample1.delta) * t;
+    return true;
 }
 
 
 void NxCurve::calcBoundingRect() {
+    qreal pathLengthOld = pathLength;
     bool calculatePathLength = false;
     foreach(NxObject *cursor, cursors)
         if(!cursor->getLockPathLength()) {
@@ -895,6 +1048,8 @@ void NxCurve::calcBoundingRect() {
 
     if(pathLength == 0)
         pathLength = 1;
+    if(pathLength != pathLengthOld)
+        invalidatePathSamples();
 
     if(!Transport::timerOk)
         calculate();
@@ -32,6 +32,7 @@
 #include "nxobject.h"
 #include "qmath.h"
 #include "items/uipathpointsitem.h"
+#include "nxcurvevectorizer.h"
 #include "../abstractionsgl.h"
 #ifdef Q_OS_WIN
 #define M_E        2.71828182845904523536
@@ -50,6 +51,8 @@
 #endif
 
 #define CURVE_PATH_POINTS   300
+#define CURVE_SAMPLES_MIN   1024
+#define CURVE_SAMPLES_MAX   16384
 
 using namespace mu;
 
@@ -57,6 +60,12 @@ enum CurveType       { CurveTypePoints, CurveTypeEllipse, CurveTypeEquationCarte
 
 Q_DECLARE_METATYPE(QList<qreal>)
 
+class NxCurveSample {
+public:
+    NxPoint point, delta;
+    quint16 segment;
+};
+
 class NxCurve : public NxObject {
     Q_OBJECT
 
@@ -110,8 +119,27 @@ private:
     QHash<QString,qreal> equationVariables;
     qreal equationVariableT, equationNbPoints, equationVariableTSteps;
     Parser equationParser;
-    bool equationIsValid, curveNeedUpdate;
+    bool equationIsValid, equationIsDerivable, curveNeedUpdate;
     int equationNbEval;
+
+    //Path samples shared by the cursors of the curve
+private:
+    QVector<NxCurveSample> pathSamples;
+    bool pathSamplesValid;
+    quint32 pathSamplesLookups;
+    void calcPathSamples();
+    bool getPathSampleAt(qreal val, NxPoint *point, NxPoint *delta);
+public:
+    inline void invalidatePathSamples() {
+        pathSamplesValid   = false;
+        pathSamplesLookups = 0;
+    }
+    inline quint16 getPathSamplesCount() const {
+        if(curveType == CurveTypePoints)
+            return (pathPoints.count() > 1)?(qBound(CURVE_SAMPLES_MIN, pathPoints.count() * 8, CURVE_SAMPLES_MAX)):(0);
+        else
+            return qBound(CURVE_SAMPLES_MIN, (int)equationNbPoints * 4, CURVE_SAMPLES_MAX);
+    }
 public:
     void setPointXAt(const QList<qreal> &points) {
         quint16 indexPoint = points.at(0);
@@ -247,6 +275,7 @@ public:
             pathLength = _pathLength;
         else
             curveNeedUpdate = true;
+        invalidatePathSamples();
     }
     inline void setInertie(qreal _inertie) {
         inertie = _inertie;
@@ -271,9 +300,14 @@ public:
     }
     inline void updatePathPointsAt(quint16 index, const NxCurvePoint &pt) {
         pathPoints[qBound(0, (int)index, pathPoints.count()-1)] = pt;
+        invalidatePathSamples();
     }
 
     void computeInertie();
+    void computeSmooth();
+private:
+    bool storePointAt(quint16 index, const NxPoint & point, const NxPoint & c1, const NxPoint & c2, bool smooth);
+public:
 
     inline quint16 getPathPointsCount() const { return pathPoints.count(); }
 
@@ -413,12 +447,29 @@ public:
     }
 
 
-    void setPath(const QPainterPath &path);
+    void setPath(const QPainterPath &path, bool fromGui = false);
+public slots:
+    void setImageFinished();
+public:
     void resize(const NxSize & size);
     void resize(qreal sizeFactorW, qreal sizeFactorH);
     inline NxPoint getPointAt(quint16 index, qreal t);
+    inline NxPoint getTangentAt(quint16 index, qreal t);
+    quint16 getPathPointsIndexAt(qreal val, bool absoluteTime, qreal *t);
     NxPoint getPointAt(qreal val, bool absoluteTime = false);
-    NxPoint getAngleAt(qreal val, bool absoluteTime = false);
+    NxPoint getPointAndAngleAt(qreal val, NxPoint *angle, bool absoluteTime = false);
+    inline NxPoint getAngleAt(qreal val, bool absoluteTime = false) {
+        NxPoint angle;
+        getPointAndAngleAt(val, &angle, absoluteTime);
+        return angle;
+    }
+    bool getPointAndDeltaAt(qreal val, NxPoint *point, NxPoint *delta, quint16 *segment, bool absoluteTime);
+    NxPoint getDeltaAtFinite(qreal val, const NxPoint &point, bool absoluteTime);
+    static inline NxPoint getAngleFromDelta(const NxPoint &deltaPos) {
+        return NxPoint(0,
+                       qAtan2(qSqrt(deltaPos.x()*deltaPos.x() + deltaPos.y()*deltaPos.y()), deltaPos.z()) * 180.0F / M_PI + 90 + 180,
+                       qAtan2(deltaPos.x(), deltaPos.y()) * 180.0F / M_PI + 90);
+    }
     qreal intersects(const NxRect &rect, NxPoint* collisionPoint = 0);
 
     inline void setResize(const NxSize & size) {
@@ -533,6 +584,7 @@ public:
     inline void update() {
         if(curveNeedUpdate) {
             curveNeedUpdate = false;
+            invalidatePathSamples();
             if((curveType == CurveTypeEquationCartesian) || (curveType == CurveTypeEquationPolar))
                 calcEquation();
             calcBoundingRect();
@@ -0,0 +1,75 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nxcurveimport.h"
+#include "nxcurve.h"
+
+bool NxCurveImport::readSVG(const QString &filename, QVector<NxCurveImportItem> &items) {
+    QFile svgFile(filename);
+    if(!svgFile.open(QFile::ReadOnly))
+        return false;
+
+    //Streamed reading, only path data is kept
+    QXmlStreamReader xml(&svgFile);
+    while(!xml.atEnd()) {
+        if(xml.readNext() == QXmlStreamReader::StartElement) {
+            if(xml.name() == "path")
+                items.append(NxCurveImportItem(xml.attributes().value("d").toString(), false));
+            else if(xml.name() == "polyline")
+                items.append(NxCurveImportItem(xml.attributes().value("points").toString(), true));
+        }
+    }
+    if(xml.hasError())
+        qDebug("[SVG] %s (line %lld)", qPrintable(xml.errorString()), (qint64)xml.lineNumber());
+    svgFile.close();
+    return true;
+}
+
+void NxCurveImport::parse(QVector<NxCurveImportItem> &items, qreal scale) {
+    //Paths are independent, each job parses a chunk in place
+    QThreadPool pool;
+    NxCurveImportItem *itemsData = items.data();
+    for(quint32 index = 0 ; index < (quint32)items.count() ; index += NXCURVEIMPORT_CHUNK)
+        pool.start(new NxCurveImportJob(itemsData + index, qMin((quint32)NXCURVEIMPORT_CHUNK, items.count() - index), scale));
+    pool.waitForDone();
+}
+
+void NxCurveImportJob::run() {
+    for(quint32 index = 0 ; index < count ; index++) {
+        NxCurveImportItem &item = items[index];
+        QPainterPath path;
+        if(item.isPolyline) {
+            //Polylines are not flipped vertically by NxCurve::setPath
+            QStringList tokens = item.data.simplified().replace(",", " ").split(" ", QString::SkipEmptyParts);
+            for(quint32 tokenIndex = 1 ; tokenIndex < (quint32)tokens.count() ; tokenIndex += 2) {
+                QPointF point(tokens.at(tokenIndex-1).toDouble(), -tokens.at(tokenIndex).toDouble());
+                if(tokenIndex == 1) path.moveTo(point);
+                else                path.lineTo(point);
+            }
+        }
+        else
+            parsePathDataFast(item.data, path);
+        item.path = QTransform::fromScale(scale, scale).map(path);
+        item.data.clear();
+    }
+}
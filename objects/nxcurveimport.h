@@ -0,0 +1,69 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NXCURVEIMPORT_H
+#define NXCURVEIMPORT_H
+
+#include <QRunnable>
+#include <QThreadPool>
+#include <QPainterPath>
+#include <QTransform>
+#include <QVector>
+#include <QFile>
+#include <QXmlStreamReader>
+
+#define NXCURVEIMPORT_CHUNK 64
+
+class NxCurveImportItem {
+public:
+    QString      data;
+    bool         isPolyline;
+    QPainterPath path;
+public:
+    explicit NxCurveImportItem(const QString &_data = QString(), bool _isPolyline = false) {
+        data       = _data;
+        isPolyline = _isPolyline;
+    }
+};
+
+class NxCurveImportJob : public QRunnable {
+private:
+    NxCurveImportItem *items;
+    quint32 count;
+    qreal scale;
+public:
+    explicit NxCurveImportJob(NxCurveImportItem *_items, quint32 _count, qreal _scale) {
+        items = _items;
+        count = _count;
+        scale = _scale;
+    }
+    void run();
+};
+
+class NxCurveImport {
+public:
+    static bool readSVG(const QString &filename, QVector<NxCurveImportItem> &items);
+    static void parse(QVector<NxCurveImportItem> &items, qreal scale);
+};
+
+#endif // NXCURVEIMPORT_H
@@ -0,0 +1,223 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nxcurvevectorizer.h"
+#include "qmath.h"
+
+UiReal NxCurveVectorizer::pointsBudget = 2000;
+
+//Marching squares: corners are tl(8) tr(4) br(2) bl(1), edges are top(0) right(1) bottom(2) left(3)
+//Segments are oriented so that the shape is always on the same side (saddles keep corners apart)
+static const qint8 marchingSegments[16][4] = {
+    {-1, -1, -1, -1},
+    { 3,  2, -1, -1},
+    { 2,  1, -1, -1},
+    { 3,  1, -1, -1},
+    { 1,  0, -1, -1},
+    { 1,  0,  3,  2},
+    { 2,  0, -1, -1},
+    { 3,  0, -1, -1},
+    { 0,  3, -1, -1},
+    { 0,  2, -1, -1},
+    { 0,  3,  2,  1},
+    { 0,  1, -1, -1},
+    { 1,  3, -1, -1},
+    { 1,  2, -1, -1},
+    { 2,  3, -1, -1},
+    {-1, -1, -1, -1}
+};
+//Middle of each edge, in half-pixels
+static const quint8 marchingEdges[4][2] = { {1, 0}, {2, 1}, {1, 2}, {0, 1} };
+
+NxCurveVectorizer::NxCurveVectorizer(const QString &_filename, QObject *parent) :
+    QThread(parent) {
+    filename = _filename;
+    budget   = qBound(16., (qreal)pointsBudget, 65000.);
+    connect(this, SIGNAL(finished()), SLOT(deleteLater()));
+}
+
+void NxCurveVectorizer::run() {
+    //QImage (unlike QPixmap) can be used outside of the GUI thread
+    QImage image(filename);
+    if(image.isNull()) {
+        qDebug("[Vectorizer] %s can't be loaded", qPrintable(filename));
+        return;
+    }
+    QImage mask = image.createHeuristicMask().convertToFormat(QImage::Format_Indexed8);
+
+    //Contours
+    QList< QVector<QPointF> > contours;
+    trace(mask, contours);
+
+    //Simplification until the point budget is met
+    QList< QVector<QPointF> > simplifiedContours;
+    qreal epsilon = 0.5;
+    for(quint8 iteration = 0 ; iteration < 32 ; iteration++) {
+        quint32 pointsCount = 0;
+        simplifiedContours.clear();
+        foreach(const QVector<QPointF> &contour, contours) {
+            QVector<QPointF> simplified;
+            simplify(contour, epsilon, simplified);
+            if(simplified.count() > 3) {
+                simplifiedContours.append(simplified);
+                pointsCount += simplified.count();
+            }
+        }
+        if(pointsCount <= budget)
+            break;
+        epsilon *= 1.5;
+    }
+
+    //Béziers
+    foreach(const QVector<QPointF> &simplified, simplifiedContours)
+        fit(simplified, path);
+}
+
+void NxCurveVectorizer::trace(const QImage &mask, QList< QVector<QPointF> > &contours) {
+    //Padded binary grid so that every contour is closed
+    quint32 width = mask.width() + 2, height = mask.height() + 2;
+    QVector<quint8> grid(width * height, 0);
+    for(quint32 y = 0 ; y < (quint32)mask.height() ; y++) {
+        const uchar *line = mask.constScanLine(y);
+        for(quint32 x = 0 ; x < (quint32)mask.width() ; x++)
+            grid[(y+1) * width + (x+1)] = (line[x] != 0);
+    }
+
+    //Segments, indexed by their start (in half-pixels)
+    QVector<quint64> segmentsEnd;
+    QVector<bool>    segmentsDone;
+    QHash<quint64, quint32> segmentsStart;
+    for(quint32 y = 0 ; y < height-1 ; y++) {
+        for(quint32 x = 0 ; x < width-1 ; x++) {
+            quint8 cell = (grid.at(y * width + x) << 3) | (grid.at(y * width + x+1) << 2) | (grid.at((y+1) * width + x+1) << 1) | grid.at((y+1) * width + x);
+            for(quint8 segment = 0 ; (segment < 4) && (marchingSegments[cell][segment] >= 0) ; segment += 2) {
+                const quint8 *from = marchingEdges[marchingSegments[cell][segment]], *to = marchingEdges[marchingSegments[cell][segment+1]];
+                quint64 start = ((quint64)(2*y + from[1]) << 32) | (2*x + from[0]);
+                quint64 end   = ((quint64)(2*y + to[1])   << 32) | (2*x + to[0]);
+                segmentsStart.insert(start, segmentsEnd.count());
+                segmentsEnd.append(end);
+            }
+        }
+    }
+    segmentsDone.fill(false, segmentsEnd.count());
+
+    //Chaining
+    QHashIterator<quint64, quint32> segmentsIterator(segmentsStart);
+    while(segmentsIterator.hasNext()) {
+        segmentsIterator.next();
+        if(segmentsDone.at(segmentsIterator.value()))
+            continue;
+        QVector<QPointF> contour;
+        quint64 point   = segmentsIterator.key();
+        quint32 segment = segmentsIterator.value();
+        while(!segmentsDone.at(segment)) {
+            segmentsDone[segment] = true;
+            //Back to pixel coordinates, minus the padding
+            contour.append(QPointF((point & 0xFFFFFFFF) / 2. - 1, (point >> 32) / 2. - 1));
+            point = segmentsEnd.at(segment);
+            if(!segmentsStart.contains(point))
+                break;
+            segment = segmentsStart.value(point);
+        }
+        if(contour.count() > 2)
+            contours.append(contour);
+    }
+}
+
+void NxCurveVectorizer::simplify(const QVector<QPointF> &contour, qreal epsilon, QVector<QPointF> &simplified) {
+    //Closed contour: split at the farthest point from the start, then Douglas–Peucker on both halves
+    quint32 farthest = 0;
+    qreal farthestDistance = 0;
+    for(quint32 index = 1 ; index < (quint32)contour.count() ; index++) {
+        QPointF delta = contour.at(index) - contour.at(0);
+        qreal distance = delta.x()*delta.x() + delta.y()*delta.y();
+        if(distance > farthestDistance) {
+            farthestDistance = distance;
+            farthest = index;
+        }
+    }
+    if(farthest == 0)
+        return;
+
+    QVector<QPointF> closed = contour;
+    closed.append(contour.at(0));
+    QVector<bool> keep(closed.count(), false);
+    keep[0] = keep[farthest] = keep[closed.count()-1] = true;
+    simplify(closed, 0, farthest, epsilon*epsilon, keep);
+    simplify(closed, farthest, closed.count()-1, epsilon*epsilon, keep);
+    for(quint32 index = 0 ; index < (quint32)closed.count() ; index++)
+        if(keep.at(index))
+            simplified.append(closed.at(index));
+}
+
+void NxCurveVectorizer::simplify(const QVector<QPointF> &contour, quint32 first, quint32 last, qreal epsilon2, QVector<bool> &keep) {
+    //Iterative, contours of large images would overflow the thread stack
+    QVector< QPair<quint32, quint32> > ranges;
+    ranges.append(qMakePair(first, last));
+    while(ranges.count()) {
+        QPair<quint32, quint32> range = ranges.last();
+        ranges.pop_back();
+        if(range.second <= range.first + 1)
+            continue;
+
+        QPointF segment = contour.at(range.second) - contour.at(range.first);
+        qreal segmentLength2 = segment.x()*segment.x() + segment.y()*segment.y();
+        quint32 farthest = range.first;
+        qreal farthestDistance2 = 0;
+        for(quint32 index = range.first+1 ; index < range.second ; index++) {
+            QPointF delta = contour.at(index) - contour.at(range.first);
+            qreal distance2;
+            if(segmentLength2 > 0) {
+                qreal cross = segment.x()*delta.y() - segment.y()*delta.x();
+                distance2 = cross*cross / segmentLength2;
+            }
+            else
+                distance2 = delta.x()*delta.x() + delta.y()*delta.y();
+            if(distance2 > farthestDistance2) {
+                farthestDistance2 = distance2;
+                farthest = index;
+            }
+        }
+        if(farthestDistance2 > epsilon2) {
+            keep[farthest] = true;
+            ranges.append(qMakePair(range.first, farthest));
+            ranges.append(qMakePair(farthest, range.second));
+        }
+    }
+}
+
+void NxCurveVectorizer::fit(const QVector<QPointF> &contour, QPainterPath &path) {
+    //Catmull-Rom tangents on smooth turns, straight lines on corners
+    quint32 count = contour.count() - 1;
+    path.moveTo(contour.at(0));
+    for(quint32 index = 0 ; index < count ; index++) {
+        const QPointF &p0 = contour.at((index + count - 1) % count), &p1 = contour.at(index), &p2 = contour.at(index + 1), &p3 = contour.at((index + 2) % count);
+        QPointF in1 = p1 - p0, out1 = p2 - p1, out2 = p3 - p2;
+        qreal cos1 = (in1 .x()*out1.x() + in1 .y()*out1.y()) / qSqrt((in1 .x()*in1 .x() + in1 .y()*in1 .y()) * (out1.x()*out1.x() + out1.y()*out1.y()) + 1e-9);
+        qreal cos2 = (out1.x()*out2.x() + out1.y()*out2.y()) / qSqrt((out1.x()*out1.x() + out1.y()*out1.y()) * (out2.x()*out2.x() + out2.y()*out2.y()) + 1e-9);
+        if((cos1 > 0.7) && (cos2 > 0.7))
+            path.cubicTo(p1 + (p2 - p0) / 6, p2 - (p3 - p1) / 6, p2);
+        else
+            path.lineTo(p2);
+    }
+}
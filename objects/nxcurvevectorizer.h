@@ -0,0 +1,59 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NXCURVEVECTORIZER_H
+#define NXCURVEVECTORIZER_H
+
+#include <QThread>
+#include <QImage>
+#include <QPainterPath>
+#include <QHash>
+#include <QVector>
+#include <QPair>
+#include "misc/options.h"
+
+class NxCurveVectorizer : public QThread {
+    Q_OBJECT
+
+public:
+    explicit NxCurveVectorizer(const QString &_filename, QObject *parent = 0);
+
+public:
+    static UiReal pointsBudget;
+private:
+    QString filename;
+    quint16 budget;
+public:
+    QPainterPath path;
+
+protected:
+    void run();
+
+private:
+    static void trace(const QImage &mask, QList< QVector<QPointF> > &contours);
+    static void simplify(const QVector<QPointF> &contour, qreal epsilon, QVector<QPointF> &simplified);
+    static void simplify(const QVector<QPointF> &contour, quint32 first, quint32 last, qreal epsilon2, QVector<bool> &keep);
+    static void fit(const QVector<QPointF> &contour, QPainterPath &path);
+};
+
+#endif // NXCURVEVECTORIZER_H
@@ -23,6 +23,8 @@
 
 #include "nxdocument.h"
 
+quint32 NxDocument::revisionLast = 0;
+
 NxDocument::NxDocument(ApplicationCurrent *parent, UiFileItem *_fileItem) :
     QObject(parent) {
     fileItem = _fileItem;
@@ -39,6 +41,7 @@ NxDocument::NxDocument(ApplicationCurrent *parent, UiFileItem *_fileItem) :
     currentCurve = 0;
     snapshotsIndex = 0;
     isLoaded = false;
+    revision = ++revisionLast;
 }
 
 
@@ -121,6 +124,30 @@ void NxDocument::open() {
         initialContent = Application::current->serialize();
     }
 }
+bool NxDocument::acceptIncomingMessage(const QString &destination) const {
+    //A destination, a wildcard pattern, a regular expression or an array of them
+    //The variable is read for each message, so the score can change it at any time
+    QScriptValue filter = script.property(scriptOnIncomingMessageFilter);
+    QScriptValueList filters;
+    if(filter.isArray()) {
+        quint32 filterLength = filter.property("length").toUInt32();
+        for(quint32 filterIndex = 0 ; filterIndex < filterLength ; filterIndex++)
+            filters << filter.property(filterIndex);
+    }
+    else if((filter.isString()) || (filter.isRegExp()))
+        filters << filter;
+    if(filters.isEmpty())
+        return true;
+
+    //Regular expressions search the destination like in JavaScript, wildcards match it whole
+    foreach(const QScriptValue &filterItem, filters) {
+        if((filterItem.isRegExp()) && (filterItem.toRegExp().indexIn(destination) != -1))
+            return true;
+        else if((filterItem.isString()) && (QRegExp(filterItem.toString(), Qt::CaseSensitive, QRegExp::Wildcard).exactMatch(destination)))
+            return true;
+    }
+    return false;
+}
 void NxDocument::open(bool configure) {
     isLoaded = false;
 
@@ -165,11 +192,13 @@ void NxDocument::open(bool configure) {
                 scriptMakeWithScript       = script.property("makeWithScript");
                 scriptOnIncomingMessage    = script.property("onIncomingMessage");
                 scriptAskUserForParameters = script.property("askUserForParameters");
+                scriptOnIncomingMessageFilter = "onIncomingMessageFilter";
             }
             else {
                 scriptOnIncomingMessage    = script.property("onMessage");
                 scriptMakeWithScript       = script.property("onCreate");
                 scriptAskUserForParameters = script.property("onConfigure");
+                scriptOnIncomingMessageFilter = "onMessageFilter";
             }
             scriptMadeThroughGUI           = script.property("madeThroughGUI");
             scriptAlterateWithScript       = script.property("alterateWithScript");
@@ -215,8 +244,50 @@ void NxDocument::open(bool configure) {
 
     if(fileItem)
         fileItem->setIcon(0, UiFileItem::iconFileOpened);
+    resetChanges();
     updateCode(true, configure);
 }
+
+const QStringList NxDocument::resolveReferences(QStringList argv) const {
+    //References only valid locally are resolved, wherever they appear
+    for(quint16 index = 1 ; index < argv.count() ; index++) {
+        QString target = argv.at(index).toLower();
+        if((target == "current") && (currentObject))
+            argv[index] = QString::number(currentObject->getId());
+        else if((target == "lastcurve") && (currentCurve))
+            argv[index] = QString::number(currentCurve->getId());
+    }
+    return argv;
+}
+void NxDocument::addChange(QStringList argv) {
+    if(argv.isEmpty())
+        return;
+
+    //Only commands that modify the score
+    QString commande = argv.at(0).toLower();
+    if(!(((commande.startsWith("set")) && (argv.count() > 2)) || (commande == COMMAND_ADD) || (commande == COMMAND_REMOVE) || (commande == COMMAND_CLEAR) || (commande == COMMAND_CURVE_POINT_RMV) || (commande == COMMAND_CURVE_POINT_SHIFT) || (commande == COMMAND_CURVE_POINT_TRANSLATE) || (commande == COMMAND_CURVE_POINT_TRANSLATE2) || (commande == COMMAND_GLOBAL_COLOR) || (commande == COMMAND_GLOBAL_COLOR_HUE) || (commande == COMMAND_TEXTURE)))
+        return;
+
+    revision++;
+    revisionLast = qMax(revisionLast, revision);
+    changes.append(resolveReferences(argv).join(" "));
+    if(changes.count() > NXDOCUMENT_CHANGES_MAX)
+        changes.removeFirst();
+}
+void NxDocument::resetChanges() {
+    //Each feed starts past every revision ever given out, by any document,
+    //so clients synced with another score (or an older open) get a full copy
+    changes.clear();
+    revision = ++revisionLast;
+}
+const QString NxDocument::getChangesSince(quint32 since) const {
+    quint32 revisionFirst = revision - changes.count();
+    if((since < revisionFirst) || (since > revision)) {
+        NxObjectDispatchProperty::source = ExecuteSourceCopyPaste;
+        return QString("full %1\n").arg(revision) + Application::current->serialize();
+    }
+    return QString("changes %1\n").arg(revision) + QStringList(changes.mid(since - revisionFirst)).join(COMMAND_END);
+}
 void NxDocument::updateCode(bool fromFile, bool raiseWindow) {
     if(!skipClose)
         Transport::editor->setContent(getContent(fromFile), raiseWindow);
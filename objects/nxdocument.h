@@ -37,6 +37,8 @@
 #include "gui/uimessagebox.h"
 #include "messages/messagemanagerloginterface.h"
 
+#define NXDOCUMENT_CHANGES_MAX 10000
+
 class NxDocument : public QObject, public QTreeWidgetItem, public MessageDispatcher, public NxObjectDispatchProperty {
     Q_OBJECT
 
@@ -79,6 +81,18 @@ public:
     void remplaceInFunction(QString *content, const QString &delimiter, const QString &data);
     QScriptValue scriptEvaluate(const QString &script, bool _createNewObjectIfExists);
 
+    //Change feed for remote viewers
+private:
+    static quint32 revisionLast;
+    quint32 revision;
+    QStringList changes;
+public:
+    inline quint32 getRevision() const { return revision; }
+    const QStringList resolveReferences(QStringList argv) const;
+    void addChange(QStringList argv);
+    void resetChanges();
+    const QString getChangesSince(quint32 since) const;
+
 public:
     QMap<QString, NxGroup*> groups;
     QHash<quint16, NxObject*> objects;
@@ -129,6 +143,7 @@ protected:
     ExtScriptVariableAsk *variable;
     QScriptValue script;
     QScriptValue scriptOnIncomingMessage, scriptMakeWithScript, scriptAlterateWithScript, scriptMadeThroughGUI, scriptMadeThroughInterfaces, scriptAskUserForParameters;
+    QString scriptOnIncomingMessageFilter;
     NxPoint mousePos;
     QString scriptContent;
 
@@ -139,16 +154,21 @@ public:
     }
 
     inline QString incomingMessage(const MessageIncomming &source, bool needOutput = false, bool = true) {
-        if(scriptOnIncomingMessage.isValid()) {
-            QString argumentsStr;
-            foreach(const QString &argument, source.arguments)
-                argumentsStr += "\"" + argument + "\",";
-            argumentsStr.chop(1);
-            if(needOutput)  return scriptOnIncomingMessage.call(QScriptValue(), QScriptValueList() << source.protocol << source.host << source.port.toString() << source.destination << scriptEngine.evaluate(QString("[%5]").arg(argumentsStr))).toString();
-            else            scriptOnIncomingMessage.call(QScriptValue(), QScriptValueList() << source.protocol << source.host << source.port.toString() << source.destination << scriptEngine.evaluate(QString("[%5]").arg(argumentsStr)));
+        if(scriptOnIncomingMessage.isFunction()) {
+            //Destinations not declared by the score don't reach the engine
+            if(!acceptIncomingMessage(source.destination))
+                return QString();
+
+            QScriptValue arguments = scriptEngine.newArray(source.arguments.count());
+            for(quint16 argumentIndex = 0 ; argumentIndex < source.arguments.count() ; argumentIndex++)
+                arguments.setProperty(argumentIndex, source.arguments.at(argumentIndex));
+            QScriptValue retour = scriptOnIncomingMessage.call(QScriptValue(), QScriptValueList() << source.protocol << source.host << source.port.toString() << source.destination << arguments);
+            if(needOutput)
+                return retour.toString();
         }
         return QString();
     }
+    bool acceptIncomingMessage(const QString &destination) const;
 
     inline const QFileInfo getScriptFile() const {
         if(fileItem)    return fileItem->filename.file;
@@ -27,12 +27,18 @@
 UiRender::UiRender(QWidget *parent, void *share) :
     Render(parent, share),
     ui(new Ui::UiRender) {
-    capturedFramesStart = false;
+    renderOffscreen = false;
+    renderTile      = QRectF(0, 0, 1, 1);
+#ifdef USE_OPENGLWIDGET
+    texturePixelBuffer = 0;
+    offscreenContext   = 0;
+    offscreenSurface   = 0;
+#endif
 
     setFocusPolicy(Qt::StrongFocus);
 #ifdef USE_OPENGLWIDGET
-    renderTextTextureIndex = 0;
     renderTextFont = OpenGlFont::getFont(Application::renderFont.family(), Qt::AlignLeft, Application::renderFont.pixelSize());
+    textAtlas.setFont(renderTextFont);
 #endif
 
     //Initialize view
@@ -72,6 +78,10 @@ UiRender::UiRender(QWidget *parent, void *share) :
     snapBeforeKeyY = Application::mouseSnapY;
 }
 UiRender::~UiRender() {
+#ifdef USE_OPENGLWIDGET
+    delete offscreenContext;
+    delete offscreenSurface;
+#endif
     delete ui;
 }
 void UiRender::changeEvent(QEvent *event) {
@@ -94,14 +104,33 @@ void UiRender::changeEvent(QEvent *event) {
 bool UiRender::loadTexture(UiRenderTexture *texture, bool gl) {
     if(gl) {
         if(texture->filename.exists()) {
+#ifdef USE_OPENGLWIDGET
+            //Snapshots render in the same context, uploaded textures stay valid
+            if((texture->loaded) && (texture->texture))
+                return true;
+#endif
+            //Decoded on the worker pool, uploaded on a later frame once ready
+            QImage tex = UiRenderTextureCache::request(texture->filename);
+            if(tex.isNull())
+                return false;
+
             glEnable(GL_TEXTURE_2D);
-            glGenTextures(1, &(texture->texture));
+            if(!texture->texture)
+                glGenTextures(1, &(texture->texture));
             glBindTexture(GL_TEXTURE_2D, texture->texture);
-#ifdef USE_GLWIDGET
-            QImage tex = QGLWidget::convertToGLFormat(QImage(texture->filename.absoluteFilePath()));
+#ifdef USE_OPENGLWIDGET
+            //Upload through a pixel buffer, mipmaps are generated once here
+            QOpenGLFunctions glFuncs(QOpenGLContext::currentContext());
+            if(!texturePixelBuffer)
+                glFuncs.glGenBuffers(1, &texturePixelBuffer);
+            glFuncs.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, texturePixelBuffer);
+            glFuncs.glBufferData(GL_PIXEL_UNPACK_BUFFER, tex.byteCount(), tex.constBits(), GL_STREAM_DRAW);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tex.width(), tex.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            glFuncs.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glFuncs.glGenerateMipmap(GL_TEXTURE_2D);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 #else
-            QImage tex = QGLWidget::convertToGLFormat(QImage(texture->filename.absoluteFilePath()));
-#endif
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tex.width(), tex.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, tex.bits());
 #ifdef Q_OS_MAC
             glGenerateMipmap(GL_TEXTURE_2D);
@@ -109,6 +138,7 @@ bool UiRender::loadTexture(UiRenderTexture *texture, bool gl) {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 #else
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+#endif
 #endif
             glDisable(GL_TEXTURE_2D);
             texture->originalSize = tex.size();
@@ -151,23 +181,20 @@ void UiRender::capture(qreal scaleFactor) {
             qDebug("Creation de la video : %d", videoEncoder.createFile("_test.avi", renderSize.width(), renderSize.height(), 5000000, 20, 25));
         }
 #else
-        if(capturedFramesStart) {
-            capturedFramesStart = false;
-            //Sauvegarde
+        //Frames are streamed to disk (or to an encoder) while rendering
+        if(frameCapture.isCapturing()) {
+            makeCurrent();
+            frameCapture.stop();
+            doneCurrent();
+        }
+        else {
 #ifdef QT4
             QString basePath = QDesktopServices::storageLocation(QDesktopServices::DesktopLocation) + "/IanniX_Capture_" + QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss") + "/";
 #else
             QString basePath = QStandardPaths::standardLocations(QStandardPaths::DesktopLocation).first() + "/IanniX_Capture_" + QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss") + "/";
 #endif
             QDir().mkpath(basePath);
-            quint16 index = 0;
-            foreach(const QImage &capturedFrame, capturedFrames)
-                capturedFrame.save(basePath + tr("Image_%1.png").arg(index++, 5, 10, QChar('0')));
-            capturedFrames.clear();
-        }
-        else {
-            capturedFrames.clear();
-            capturedFramesStart = true;
+            frameCapture.start(basePath, 1000. / qMax(1, timer->interval()));
         }
 #endif
     }
@@ -175,7 +202,11 @@ void UiRender::capture(qreal scaleFactor) {
         captureFrame(scaleFactor);
 }
 bool UiRender::captureFrame(qreal scaleFactor, const QString &filename) {
-    renderSize = size() * scaleFactor;
+    return captureFrame(size() * scaleFactor, filename);
+}
+bool UiRender::captureFrame(const QSize &targetSize, const QString &filename) {
+    //The frustum follows the requested size, not the window one
+    renderSize = targetSize;
     Render::forceLists         = true;
     Render::forceTexture       = true;
     Render::forceFrustumInInit = true;
@@ -193,24 +224,131 @@ bool UiRender::captureFrame(qreal scaleFactor, const QString &filename) {
         renderPixmap(renderSize.width(), renderSize.height()).save(filename);
     }
 #else
-    if(filename.isEmpty()) {
-#ifdef USE_GLWIDGET
-        QPixmap picture = QPixmap::fromImage(grabFrameBuffer());
-#else
-        QPixmap picture = QPixmap::fromImage(grabFramebuffer());
-#endif
-        (new UiMessageBox())->display(tr("Graphical card error"), tr("Due to hardware issue, the high resolution snapshot creation failed.\nA classical snapshot has been saved on your desktop."));
-        picture.save(QStandardPaths::standardLocations(QStandardPaths::DesktopLocation).first() + "/IanniX_Capture_" + QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss") + ".png");
-    }/* else {
-        QDir().mkpath(QFileInfo(filename).absoluteDir().absolutePath());
-        renderPixmap(renderSize.width(), renderSize.height()).save(filename);
-    }*/
+    //Offscreen rendering, independent of the window size
+    QString path = filename;
+    if(path.isEmpty())
+        path = QStandardPaths::standardLocations(QStandardPaths::DesktopLocation).first() + "/IanniX_Capture_" + QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss") + ".png";
+    QImage picture = renderOffscreenImage(targetSize * OpenGlDrawing::dpi);
+    if(picture.isNull()) {
+        picture = grabFramebuffer();
+        if(filename.isEmpty())
+            (new UiMessageBox())->display(tr("Graphical card error"), tr("Due to hardware issue, the high resolution snapshot creation failed.\nA classical snapshot has been saved on your desktop."));
+    }
+    QDir().mkpath(QFileInfo(path).absoluteDir().absolutePath());
+    picture.save(path);
 #endif
     Render::forceLists         = false;
     Render::forceTexture       = false;
     Render::forceFrustumInInit = false;
     return true;
 }
+#ifdef USE_OPENGLWIDGET
+void UiRender::resetGlResources() {
+    //Handles created in another share group name nothing in the current context
+    foreach(UiRenderTexture *texture, *Render::textures) {
+        texture->loaded  = false;
+        texture->texture = 0;
+    }
+    textAtlas.resetTexture();
+    texturePixelBuffer = 0;
+}
+void UiRender::releaseOffscreenContext() {
+    if(!offscreenContext)
+        return;
+    bool shared = (offscreenContext->shareContext() != 0);
+    offscreenContext->doneCurrent();
+    delete offscreenContext;
+    delete offscreenSurface;
+    offscreenContext = 0;
+    offscreenSurface = 0;
+    if(!shared)
+        resetGlResources();
+}
+QImage UiRender::renderOffscreenImage(const QSize &imageSize) {
+    //Widget context, or a private one kept for the whole headless export (window never shown)
+    if(context()) {
+        releaseOffscreenContext();
+        makeCurrent();
+    }
+    else if(offscreenContext) {
+        if(!offscreenContext->makeCurrent(offscreenSurface)) {
+            qDebug("[SNAPSHOT] No OpenGL context available");
+            return QImage();
+        }
+    }
+    else {
+        offscreenSurface = new QOffscreenSurface();
+        offscreenSurface->setFormat(format());
+        offscreenSurface->create();
+        offscreenContext = new QOpenGLContext();
+        offscreenContext->setFormat(format());
+        offscreenContext->setShareContext(QOpenGLContext::globalShareContext());
+        if((!offscreenContext->create()) || (!offscreenContext->makeCurrent(offscreenSurface))) {
+            qDebug("[SNAPSHOT] No OpenGL context available");
+            delete offscreenContext;
+            delete offscreenSurface;
+            offscreenContext = 0;
+            offscreenSurface = 0;
+            return QImage();
+        }
+        //Without a global share context, nothing uploaded before exists here
+        if(!offscreenContext->shareContext())
+            resetGlResources();
+        initializeGL();
+    }
+
+    //Textures still being decoded are waited for
+    foreach(UiRenderTexture *texture, *Render::textures)
+        if((!texture->loaded) && (texture->filename.exists()))
+            UiRenderTextureCache::request(texture->filename);
+    UiRenderTextureCache::waitForDone();
+
+    //Tiles are bounded by the viewport and renderbuffer limits of the driver
+    GLint maxViewport[2] = {0, 0}, maxRenderbuffer = 0;
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS,     maxViewport);
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+    int tileMax = qBound(256, qMin(qMin((int)maxViewport[0], (int)maxViewport[1]), (int)maxRenderbuffer), UIRENDER_TILE_MAX);
+    QSize tileSize(qMin(imageSize.width(), tileMax), qMin(imageSize.height(), tileMax));
+
+    QOpenGLFramebufferObjectFormat framebufferFormat;
+    if(QOpenGLFramebufferObject::hasOpenGLFramebufferBlit())
+        framebufferFormat.setSamples(4);
+    QOpenGLFramebufferObject *framebuffer = new QOpenGLFramebufferObject(tileSize, framebufferFormat);
+    QImage picture;
+    if(framebuffer->isValid()) {
+        picture = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&picture);
+        renderOffscreen = true;
+        for(int y = 0 ; y < imageSize.height() ; y += tileSize.height()) {
+            for(int x = 0 ; x < imageSize.width() ; x += tileSize.width()) {
+                //Each tile renders its own part of the frustum
+                QSize tile(qMin(tileSize.width(), imageSize.width() - x), qMin(tileSize.height(), imageSize.height() - y));
+                renderTile = QRectF((qreal)x / imageSize.width(), (qreal)y / imageSize.height(), (qreal)tile.width() / imageSize.width(), (qreal)tile.height() / imageSize.height());
+                framebuffer->bind();
+                glViewport(0, 0, tile.width(), tile.height());
+                setFrustum();
+                paintGL();
+                painter.drawImage(x, y, framebuffer->toImage().copy(0, tileSize.height() - tile.height(), tile.width(), tile.height()));
+            }
+        }
+        painter.end();
+        renderOffscreen = false;
+        renderTile = QRectF(0, 0, 1, 1);
+        framebuffer->release();
+    }
+    else
+        qDebug("[SNAPSHOT] Framebuffer objects are not available");
+    delete framebuffer;
+
+    if(offscreenContext)
+        offscreenContext->doneCurrent();
+    else {
+        glViewport(0, 0, width() * OpenGlDrawing::dpi, height() * OpenGlDrawing::dpi);
+        doneCurrent();
+    }
+    return picture;
+}
+#endif
 
 void UiRender::centerOn(const NxPoint & center, bool force) {
     Render::axisCenterDest = -center;
@@ -295,13 +433,19 @@ void UiRender::setFrustum() {
     Render::axisArea.translate(-NxPoint(Render::axisArea.size().width()/2, Render::axisArea.size().height()/2));
     Render::axisArea.translate(-Render::axisCenter);
 
+    //Part of the frustum drawn (offscreen tiles)
+    qreal frustumLeft   = Render::axisArea.left() + Render::axisArea.width()  * renderTile.left();
+    qreal frustumRight  = Render::axisArea.left() + Render::axisArea.width()  * renderTile.right();
+    qreal frustumTop    = Render::axisArea.top()  + Render::axisArea.height() * renderTile.top();
+    qreal frustumBottom = Render::axisArea.top()  + Render::axisArea.height() * renderTile.bottom();
+
     //Set axis
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     if(cameraPerspective)
-        glFrustum(Render::axisArea.left(), Render::axisArea.right(), Render::axisArea.bottom(), Render::axisArea.top(), 50, 650.0);
+        glFrustum(frustumLeft, frustumRight, frustumBottom, frustumTop, 50, 650.0);
     else
-        glOrtho(Render::axisArea.left(), Render::axisArea.right(), Render::axisArea.bottom(), Render::axisArea.top(), -650, 650);
+        glOrtho(frustumLeft, frustumRight, frustumBottom, frustumTop, -650, 650);
     glMatrixMode(GL_MODELVIEW);
 }
 
@@ -315,15 +459,17 @@ void UiRender::paintGL() {
                 loadTexture(textureIterator.value(), true);
         }
 
-        //Intertial system
-        Render::axisCenter = Render::axisCenter + (Render::axisCenterDest - Render::axisCenter) / 3;
-        Render::zoomLinear = Render::zoomLinear + (Render::zoomLinearDest - Render::zoomLinear) / 3;
-        Render::rotation = Render::rotation + (Render::rotationDest - Render::rotation) / 6;
-        Render::rotationCenter = Render::rotationCenter + (Render::rotationCenterDest - Render::rotationCenter) / 6;
-        //if(qAbs(UiRenderOptions::rotation.z() - UiRenderOptions::rotationDest.z()) > 360)
-        //    UiRenderOptions::rotation.setZ(UiRenderOptions::rotationDest.z());
-        translation = translation + (translationDest - translation) / 3;
-        scale = scale + (scaleDest - scale) / 3;
+        //Intertial system (frozen while tiles of a same frame are rendered)
+        if(!renderOffscreen) {
+            Render::axisCenter = Render::axisCenter + (Render::axisCenterDest - Render::axisCenter) / 3;
+            Render::zoomLinear = Render::zoomLinear + (Render::zoomLinearDest - Render::zoomLinear) / 3;
+            Render::rotation = Render::rotation + (Render::rotationDest - Render::rotation) / 6;
+            Render::rotationCenter = Render::rotationCenter + (Render::rotationCenterDest - Render::rotationCenter) / 6;
+            //if(qAbs(UiRenderOptions::rotation.z() - UiRenderOptions::rotationDest.z()) > 360)
+            //    UiRenderOptions::rotation.setZ(UiRenderOptions::rotationDest.z());
+            translation = translation + (translationDest - translation) / 3;
+            scale = scale + (scaleDest - scale) / 3;
+        }
 
         //Object sizes
         Render::objectSize = getAutoScale(Application::objectsAutosize/100.);
@@ -438,6 +584,13 @@ void UiRender::paintGL() {
 #endif
         }
         glPopMatrix();
+#ifdef USE_OPENGLWIDGET
+        textAtlas.draw();
+
+        //Offscreen tiles are not exported nor previewed
+        if(renderOffscreen)
+            return;
+#endif
 
 #ifdef FFMPEG_INSTALLED
         if(videoEncoder.isOk())
@@ -486,11 +639,11 @@ void UiRender::paintGL() {
             glDisable(GL_TEXTURE_2D);
             Application::current->getRenderPreview()->paintPreview(this, renderPreviewTexture, renderSize * OpenGlDrawing::dpi);
         }
-        if(capturedFramesStart)
+        if(frameCapture.isCapturing())
 #ifdef USE_GLWIDGET
-            capturedFrames << grabFrameBuffer();
+            frameCapture.grab(grabFrameBuffer());
 #else
-            capturedFrames << grabFramebuffer();
+            frameCapture.grab(renderSize * OpenGlDrawing::dpi);
 #endif
     }
 }
@@ -1357,46 +1510,7 @@ void UiRender::arrangeObjects(quint16 type) {
 
 #ifdef USE_OPENGLWIDGET
 void UiRender::renderText(qreal x, qreal y, qreal z, const QString &text, const QFont &, bool billboarded) {
-    while(OpenGlTexture::textures.count() < 500) {
-        OpenGlTexture *texte = new OpenGlTexture(this, text, renderTextFont, QSizeF(1024, 128) * OpenGlDrawing::dpi);
-        OpenGlTexture::textures.append(texte);
-    }
-    OpenGlTexture *textTextureToUse = 0;
-    foreach(OpenGlTexture *textTexture, OpenGlTexture::textures)
-        if(textTexture->texte == text) {
-            textTextureToUse = textTexture;
-            break;
-        }
-
-    if(!textTextureToUse) {
-        OpenGlTexture::textures[renderTextTextureIndex]->loadTexte(text, renderTextFont, OpenGlTexture::textures.at(renderTextTextureIndex)->size);
-        textTextureToUse = OpenGlTexture::textures.at(renderTextTextureIndex);
-        //qDebug("ICI GENERATION %d", renderTextTextureIndex);
-        renderTextTextureIndex = (renderTextTextureIndex+1) % OpenGlTexture::textures.count();
-    }
-    if(textTextureToUse) {
-        glPushMatrix();
-        glTranslatef(x, y, z);
-
-        //Texte billboardé ou non
-        if(billboarded) {
-            glRotatef(Render::rotation.z(), 0, 0, -1);
-            glRotatef(Render::rotation.x(), 0, -1, 0);
-            glRotatef(Render::rotation.y(), -1, 0, 0);
-        }
-
-        //glScalef(0.05/(scale*OpenGlDrawing::dpi), -0.05/(scale*OpenGlDrawing::dpi), 0.05/(scale*OpenGlDrawing::dpi));
-        qreal textScale = getAutoScale(1) * 0.06;
-        glScalef(textScale, -textScale, textScale);
-        textTextureToUse->pushTexture();
-        glBegin(GL_QUADS);
-        glTexCoord2f(0, 0); glVertex3f(0, textTextureToUse->size.height(), 0);
-        glTexCoord2f(1, 0); glVertex3f(textTextureToUse->size.width(), textTextureToUse->size.height(), 0);
-        glTexCoord2f(1, 1); glVertex3f(textTextureToUse->size.width(), 0, 0);
-        glTexCoord2f(0, 1); glVertex3f(0, 0, 0);
-        glEnd();
-        textTextureToUse->popTexture();
-        glPopMatrix();
-    }
+    //Labels are batched in the glyph atlas and drawn once at the end of the frame
+    textAtlas.addText(x, y, z, text, getAutoScale(1) * 0.06, billboarded);
 }
 #endif
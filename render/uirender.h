@@ -38,12 +38,20 @@
 #include "objects/nxdocument.h"
 #include "misc/application.h"
 #include "abstractionsgl.h"
+#ifdef USE_OPENGLWIDGET
+#include <QOpenGLFramebufferObject>
+#include <QOffscreenSurface>
+#endif
 
 #include "render/uirenderpreview.h"
+#include "render/uirendertexturecache.h"
+#include "render/uirendercapture.h"
 #ifdef FFMPEG_INSTALLED
 #include "interfaces/qffmpeg/QVideoEncoder.h"
 #endif
 
+#define UIRENDER_TILE_MAX 4096
+
 namespace Ui {
     class UiRender;
 }
@@ -84,8 +92,7 @@ private:
     UiRenderSelection selection;
     NxPoint translation, translationDest, rotationDrag, translationDrag;
     qreal scale, scaleDest;
-    QList<QImage> capturedFrames;
-    bool capturedFramesStart;
+    UiRenderCapture frameCapture;
 public:
     QString legend;
     QColor legendColor;
@@ -133,6 +140,14 @@ signals:
 private:
     QTimer *timer;
     QSize renderSize;
+    QRectF renderTile;
+    bool renderOffscreen;
+#ifdef USE_OPENGLWIDGET
+    QOpenGLContext    *offscreenContext;
+    QOffscreenSurface *offscreenSurface;
+    void releaseOffscreenContext();
+    void resetGlResources();
+#endif
 protected:
     void initializeGL();
     void resizeGL(int width, int height);
@@ -223,6 +238,10 @@ public slots:
     void arrangeObjects(NxObject *objet, const NxPoint &pt);
     void capture(qreal scaleFactor);
     bool captureFrame(qreal scaleFactor, const QString &filename = "");
+    bool captureFrame(const QSize &targetSize, const QString &filename = "");
+#ifdef USE_OPENGLWIDGET
+    QImage renderOffscreenImage(const QSize &imageSize);
+#endif
 
 signals:
     void actionRouteNew();
@@ -255,8 +274,9 @@ public:
     inline void qglClearColor(const QColor &color) {
         glClearColor(color.redF(), color.greenF(), color.blueF(), color.alphaF());
     }
-    quint16 renderTextTextureIndex;
     OpenGlFont renderTextFont;
+    OpenGlTextAtlas textAtlas;
+    GLuint texturePixelBuffer;
     void renderText(qreal x, qreal y, qreal z, const QString &text, const QFont &font, bool billboarded);
     /*
     inline void renderText(double x, double y, double z, const QString &str, const QFont & font = QFont()) {
@@ -0,0 +1,219 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "uirendercapture.h"
+
+UiString UiRenderCapture::encoder;
+
+UiRenderCapture::UiRenderCapture() {
+    capturing      = false;
+    fps            = 25;
+    framesCaptured = framesWritten = framesDropped = 0;
+#ifdef USE_OPENGLWIDGET
+    buffersIndex   = 0;
+    resolveBuffer  = 0;
+    for(quint8 index = 0 ; index < UIRENDERCAPTURE_BUFFERS ; index++)
+        buffers[index] = 0;
+#endif
+}
+UiRenderCapture::~UiRenderCapture() {
+#ifdef USE_OPENGLWIDGET
+    //No GL context here, frames left in pixel buffers are lost
+    buffersIndex = 0;
+#endif
+    if(capturing)
+        stop();
+#ifdef USE_OPENGLWIDGET
+    for(quint8 index = 0 ; index < UIRENDERCAPTURE_BUFFERS ; index++)
+        if(buffers[index])
+            delete buffers[index];
+    if(resolveBuffer)
+        delete resolveBuffer;
+#endif
+}
+
+bool UiRenderCapture::start(const QString &_basePath, qreal _fps) {
+    if(capturing)
+        return false;
+    basePath  = _basePath;
+    fps       = _fps;
+    capturing = true;
+    framesCaptured = framesWritten = framesDropped = 0;
+#ifdef USE_OPENGLWIDGET
+    buffersIndex   = 0;
+#endif
+
+    //PNG files are independent, an encoder needs its frames in order
+    quint8 workersCount = (encoder.val().isEmpty()) ? (qMax(1, QThread::idealThreadCount() - 1)) : (1);
+    for(quint8 index = 0 ; index < workersCount ; index++) {
+        UiRenderCaptureWorker *worker = new UiRenderCaptureWorker(this);
+        workers.append(worker);
+        worker->start(QThread::LowPriority);
+    }
+    return true;
+}
+
+void UiRenderCapture::stop() {
+    if(!capturing)
+        return;
+#ifdef USE_OPENGLWIDGET
+    //Frames still in pixel buffers (a GL context must be current)
+    for(quint32 index = (buffersIndex > UIRENDERCAPTURE_BUFFERS) ? (buffersIndex - UIRENDERCAPTURE_BUFFERS) : (0) ; index < buffersIndex ; index++)
+        readBuffer(index % UIRENDERCAPTURE_BUFFERS);
+    buffersIndex = 0;
+#endif
+
+    mutex.lock();
+    capturing = false;
+    frameAvailable.wakeAll();
+    mutex.unlock();
+    foreach(UiRenderCaptureWorker *worker, workers) {
+        worker->wait();
+        delete worker;
+    }
+    workers.clear();
+    qDebug("[CAPTURE] %d frames captured, %d written, %d dropped", framesCaptured, framesWritten, framesDropped);
+}
+
+void UiRenderCapture::grab(const QImage &image) {
+    if(capturing)
+        enqueue(image, false);
+}
+#ifdef USE_OPENGLWIDGET
+void UiRenderCapture::grab(const QSize &size) {
+    if(!capturing)
+        return;
+
+    //Asynchronous read back: the buffer filled UIRENDERCAPTURE_BUFFERS frames ago is mapped before being reused
+    quint8 index = buffersIndex % UIRENDERCAPTURE_BUFFERS;
+    if(buffersIndex >= UIRENDERCAPTURE_BUFFERS)
+        readBuffer(index);
+    if(!buffers[index]) {
+        buffers[index] = new QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+        buffers[index]->setUsagePattern(QOpenGLBuffer::StreamRead);
+        buffers[index]->create();
+    }
+
+    //The widget framebuffer is multisampled: resolved into a single sample one before being read
+    if((!resolveBuffer) || (resolveBuffer->size() != size)) {
+        if(resolveBuffer)
+            delete resolveBuffer;
+        resolveBuffer = new QOpenGLFramebufferObject(size);
+    }
+    QOpenGLFramebufferObject::blitFramebuffer(resolveBuffer, QRect(QPoint(0, 0), size), 0, QRect(QPoint(0, 0), size));
+    resolveBuffer->bind();
+
+    buffers[index]->bind();
+    if(buffersSize[index] != size) {
+        buffers[index]->allocate(size.width() * size.height() * 4);
+        buffersSize[index] = size;
+    }
+    glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    buffers[index]->release();
+    QOpenGLFramebufferObject::bindDefault();
+    buffersIndex++;
+}
+void UiRenderCapture::readBuffer(quint8 index) {
+    if(!buffers[index])
+        return;
+    buffers[index]->bind();
+    const uchar *pixels = (const uchar*)buffers[index]->map(QOpenGLBuffer::ReadOnly);
+    if(pixels) {
+        QImage image(buffersSize[index], QImage::Format_RGBA8888);
+        memcpy(image.bits(), pixels, image.byteCount());
+        buffers[index]->unmap();
+        enqueue(image, true);
+    }
+    buffers[index]->release();
+}
+#else
+void UiRenderCapture::grab(const QSize &) {
+}
+#endif
+
+void UiRenderCapture::enqueue(const QImage &image, bool flipped) {
+    QMutexLocker locker(&mutex);
+    quint32 index = framesCaptured++;
+
+    //Bounded queue: when workers are late, frames are dropped rather than memory exhausted
+    if(queue.count() >= UIRENDERCAPTURE_QUEUE) {
+        framesDropped++;
+        return;
+    }
+    UiRenderCaptureFrame frame;
+    frame.image   = image;
+    frame.index   = index;
+    frame.flipped = flipped;
+    queue.enqueue(frame);
+    frameAvailable.wakeOne();
+}
+bool UiRenderCapture::dequeue(UiRenderCaptureFrame *frame) {
+    QMutexLocker locker(&mutex);
+    while((queue.isEmpty()) && (capturing))
+        frameAvailable.wait(&mutex);
+    if(queue.isEmpty())
+        return false;
+    *frame = queue.dequeue();
+    return true;
+}
+
+
+void UiRenderCaptureWorker::run() {
+    //Raw frames piped to an external encoder, or a PNG sequence
+    QProcess *process = 0;
+    QString command = capture->encoder.val();
+    UiRenderCaptureFrame frame;
+    while(capture->dequeue(&frame)) {
+        QImage image = (frame.flipped) ? (frame.image.mirrored()) : (frame.image);
+        if((!command.isEmpty()) && (!process)) {
+            process = new QProcess();
+#ifdef QT4
+            QString format = "bgra";
+#else
+            QString format = "rgba";
+#endif
+            process->start(QString(command).replace("{width}", QString::number(image.width())).replace("{height}", QString::number(image.height())).replace("{fps}", QString::number(capture->fps)).replace("{format}", format).replace("{path}", capture->basePath));
+            if(!process->waitForStarted())
+                qDebug("[CAPTURE] Unable to start %s", qPrintable(command));
+        }
+
+        bool written = false;
+        if(process) {
+            if(process->state() == QProcess::Running) {
+                process->write((const char*)image.constBits(), image.byteCount());
+                written = process->waitForBytesWritten(-1);
+            }
+        }
+        else
+            written = image.save(capture->basePath + QString("Image_%1.png").arg(frame.index, 5, 10, QChar('0')));
+
+        QMutexLocker locker(&capture->mutex);
+        if(written) capture->framesWritten++;
+        else        capture->framesDropped++;
+    }
+    if(process) {
+        process->closeWriteChannel();
+        process->waitForFinished(-1);
+        delete process;
+    }
+}
@@ -0,0 +1,101 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UIRENDERCAPTURE_H
+#define UIRENDERCAPTURE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QImage>
+#include <QProcess>
+#include "misc/options.h"
+#include "misc/application.h"
+#ifdef USE_OPENGLWIDGET
+#include <QOpenGLBuffer>
+#include <QOpenGLFramebufferObject>
+#endif
+
+#define UIRENDERCAPTURE_QUEUE   16
+#define UIRENDERCAPTURE_BUFFERS 3
+
+class UiRenderCapture;
+
+class UiRenderCaptureFrame {
+public:
+    QImage  image;
+    quint32 index;
+    bool    flipped;
+};
+
+class UiRenderCaptureWorker : public QThread {
+public:
+    explicit UiRenderCaptureWorker(UiRenderCapture *_capture) {
+        capture = _capture;
+    }
+protected:
+    void run();
+private:
+    UiRenderCapture *capture;
+};
+
+class UiRenderCapture {
+    friend class UiRenderCaptureWorker;
+public:
+    explicit UiRenderCapture();
+    ~UiRenderCapture();
+
+public:
+    bool start(const QString &_basePath, qreal _fps);
+    void grab(const QImage &image);
+    void grab(const QSize &size);
+    void stop();
+    inline bool isCapturing() const { return capturing; }
+
+public:
+    static UiString encoder;
+
+private:
+    void enqueue(const QImage &image, bool flipped);
+    bool dequeue(UiRenderCaptureFrame *frame);
+
+private:
+    bool    capturing;
+    QString basePath;
+    qreal   fps;
+    quint32 framesCaptured, framesWritten, framesDropped;
+    QMutex         mutex;
+    QWaitCondition frameAvailable;
+    QQueue<UiRenderCaptureFrame>  queue;
+    QList<UiRenderCaptureWorker*> workers;
+#ifdef USE_OPENGLWIDGET
+    void readBuffer(quint8 index);
+    QOpenGLBuffer *buffers[UIRENDERCAPTURE_BUFFERS];
+    QSize          buffersSize[UIRENDERCAPTURE_BUFFERS];
+    quint32        buffersIndex;
+    QOpenGLFramebufferObject *resolveBuffer;
+#endif
+};
+
+#endif // UIRENDERCAPTURE_H
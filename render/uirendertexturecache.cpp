@@ -0,0 +1,84 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "uirendertexturecache.h"
+#include <QGLWidget>
+
+QMutex                     UiRenderTextureCache::mutex;
+QThreadPool                UiRenderTextureCache::pool;
+QHash<QString, QByteArray> UiRenderTextureCache::files;
+QCache<QByteArray, QImage> UiRenderTextureCache::images(UIRENDERTEXTURECACHE_BUDGET);
+QSet<QString>              UiRenderTextureCache::pending;
+
+const QImage UiRenderTextureCache::request(const QFileInfo &filename) {
+    //A file is identified by its path, date and size; its content by a hash
+    QString key = QString("%1|%2|%3").arg(filename.absoluteFilePath()).arg(filename.lastModified().toMSecsSinceEpoch()).arg(filename.size());
+
+    QMutexLocker locker(&mutex);
+    if(files.contains(key)) {
+        QByteArray hash = files.value(key);
+        if(hash.isEmpty())
+            return QImage();
+        if(images.contains(hash))
+            return *images.object(hash);
+        //Evicted from the cache
+        files.remove(key);
+    }
+    if(!pending.contains(key)) {
+        pending.insert(key);
+        pool.start(new UiRenderTextureCacheJob(key, filename.absoluteFilePath()));
+    }
+    return QImage();
+}
+
+void UiRenderTextureCacheJob::run() {
+    QFile file(filename);
+    QByteArray data;
+    if(file.open(QFile::ReadOnly)) {
+        data = file.readAll();
+        file.close();
+    }
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+    //Identical content under another name is decoded once
+    UiRenderTextureCache::mutex.lock();
+    bool known = UiRenderTextureCache::images.contains(hash);
+    UiRenderTextureCache::mutex.unlock();
+
+    QImage *image = 0;
+    if(!known) {
+        QImage source = QImage::fromData(data);
+        if(source.isNull())
+            qDebug("[TEXTURE] Unable to decode %s", qPrintable(filename));
+        else if(source.byteCount() / 1024 >= UIRENDERTEXTURECACHE_BUDGET)
+            qDebug("[TEXTURE] %s is too large to be cached", qPrintable(filename));
+        else
+            image = new QImage(QGLWidget::convertToGLFormat(source));
+    }
+
+    QMutexLocker locker(&UiRenderTextureCache::mutex);
+    if(image)
+        UiRenderTextureCache::images.insert(hash, image, qMax(1, image->byteCount() / 1024));
+    UiRenderTextureCache::files.insert(key, ((image) || (known)) ? (hash) : (QByteArray()));
+    UiRenderTextureCache::pending.remove(key);
+}
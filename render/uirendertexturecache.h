@@ -0,0 +1,66 @@
+/*
+    This file is part of IanniX, a graphical real-time open-source sequencer for digital art
+    Copyright (C) 2010-2015 — IanniX Association
+
+    Project Manager: Thierry Coduys (http://www.le-hub.org)
+    Development:     Guillaume Jacquemin (https://www.buzzinglight.com)
+
+    This file was written by Guillaume Jacquemin.
+
+    IanniX is a free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UIRENDERTEXTURECACHE_H
+#define UIRENDERTEXTURECACHE_H
+
+#include <QRunnable>
+#include <QThreadPool>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QCache>
+#include <QImage>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+#define UIRENDERTEXTURECACHE_BUDGET 524288  //kB
+
+class UiRenderTextureCacheJob : public QRunnable {
+private:
+    QString key, filename;
+public:
+    explicit UiRenderTextureCacheJob(const QString &_key, const QString &_filename) {
+        key      = _key;
+        filename = _filename;
+    }
+    void run();
+};
+
+class UiRenderTextureCache {
+    friend class UiRenderTextureCacheJob;
+public:
+    static const QImage request(const QFileInfo &filename);
+    static inline void waitForDone() { pool.waitForDone(); }
+
+private:
+    static QMutex                     mutex;
+    static QThreadPool                pool;
+    static QHash<QString, QByteArray> files;
+    static QCache<QByteArray, QImage> images;
+    static QSet<QString>              pending;
+};
+
+#endif // UIRENDERTEXTURECACHE_H
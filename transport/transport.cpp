@@ -23,11 +23,13 @@
 
 #include "transport.h"
 #include "ui_transport.h"
+#include "messages/messagesender.h"
 
 qint64    Transport::currentMSecsSinceEpoch = 0;
 QString   Transport::timeLocalStr         = "000:00.000";
 qreal     Transport::timeLocal            = 0;
 qreal     Transport::scoreSpeed           = 1;
+qreal     Transport::syncSpeed            = 1;
 qreal     Transport::perfSchedulerRefreshTime    = 0;
 qreal     Transport::perfSchedulerCounterTime    = 0;
 qreal     Transport::perfOpenGLRefreshTime       = 0;
@@ -108,6 +110,7 @@ void Transport::refreshPerformances() {
             ui->perfSchedulerEdit->setText(QString::number(qRound(1000.0F * perfSchedulerRefreshTime / perfSchedulerCounterTime)));
         if(!ui->perfOpenGLEdit->hasFocus())
             ui->perfOpenGLEdit->setText(QString::number(qRound(1.0F * perfOpenGLCounterTime / perfOpenGLRefreshTime)));
+        ui->perfSchedulerEdit->setToolTip(MessageSenderStats::getStats());
     }
     perfSchedulerRefreshTime = 0;
     perfSchedulerCounterTime = 0;
@@ -115,30 +118,33 @@ void Transport::refreshPerformances() {
     perfOpenGLCounterTime = 0;
 }
 const QString & Transport::getTimeLocalStr() {
-    timeLocalStr = "";
-    qreal timeLocalCopy = timeLocal;
+    timeLocalStr = getTimeStr(timeLocal);
+    return timeLocalStr;
+}
+const QString Transport::getTimeStr(qreal time) {
+    QString retour;
 
-    quint16 hour = qFloor(timeLocalCopy / 3600);
-    if(hour < 10) timeLocalStr += "0";
-    timeLocalStr += QString::number(hour) + ":";
-    timeLocalCopy -= hour*3600;
+    quint16 hour = qFloor(time / 3600);
+    if(hour < 10) retour += "0";
+    retour += QString::number(hour) + ":";
+    time -= hour*3600;
 
-    quint16 min = qFloor(timeLocalCopy / 60);
-    if(min < 10) timeLocalStr += "0";
-    timeLocalStr += QString::number(min) + ":";
-    timeLocalCopy -= min*60;
+    quint16 min = qFloor(time / 60);
+    if(min < 10) retour += "0";
+    retour += QString::number(min) + ":";
+    time -= min*60;
 
-    quint8 sec = qFloor(timeLocalCopy);
-    if(sec < 10) timeLocalStr += "0";
-    timeLocalStr += QString::number(sec) + ":";
-    timeLocalCopy -= sec;
+    quint8 sec = qFloor(time);
+    if(sec < 10) retour += "0";
+    retour += QString::number(sec) + ":";
+    time -= sec;
 
-    quint16 milli = (timeLocalCopy - qFloor(timeLocalCopy)) * 1000;
-    if(milli < 10)       timeLocalStr += "00";
-    else if(milli < 100) timeLocalStr += "0";
-    timeLocalStr += QString::number(milli);
+    quint16 milli = (time - qFloor(time)) * 1000;
+    if(milli < 10)       retour += "00";
+    else if(milli < 100) retour += "0";
+    retour += QString::number(milli);
 
-    return timeLocalStr;
+    return retour;
 }
 
 void Transport::refreshTime() {
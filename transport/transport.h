@@ -79,7 +79,7 @@ public:
 
 public:
     static qint64 currentMSecsSinceEpoch;
-    static qreal timeLocal, scoreSpeed;
+    static qreal timeLocal, scoreSpeed, syncSpeed;
     static qreal perfSchedulerRefreshTime, perfSchedulerCounterTime;
     static qreal perfOpenGLRefreshTime,    perfOpenGLCounterTime;
     static QString timeLocalStr;
@@ -92,6 +92,7 @@ public:
     static UiTimer  *bigTimer;
     static UiEditor *editor;
     static const QString& getTimeLocalStr();
+    static const QString getTimeStr(qreal time);
     UiAbout *about;
 private:
     bool speedLock;